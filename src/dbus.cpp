@@ -7,6 +7,9 @@
 #include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
 
+#include <map>
+#include <variant>
+
 DBusNotifySink::DBusNotifySink(sdbusplus::bus::bus& dbus) : dbus(dbus) {}
 
 int DBusNotifySink::getFD()
@@ -27,6 +30,35 @@ void PropertiesChanged::read(Args&&... args)
     message.read(args...);
 }
 
+std::optional<bool> PropertiesChanged::findBool(const std::string& property)
+{
+    std::string interface;
+    /* Values of other types are skipped */
+    std::map<std::string, std::variant<bool, std::string>> changed;
+
+    try
+    {
+        message.read(interface, changed);
+    }
+    catch (const sdbusplus::exception::exception&)
+    {
+        return std::nullopt;
+    }
+
+    auto found = changed.find(property);
+    if (found == changed.end())
+    {
+        return std::nullopt;
+    }
+
+    if (const bool* value = std::get_if<bool>(&found->second))
+    {
+        return *value;
+    }
+
+    return std::nullopt;
+}
+
 class PropertiesChangedListener
 {
   public:
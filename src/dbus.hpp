@@ -5,6 +5,8 @@
 #include "notify.hpp"
 
 #include <memory>
+#include <optional>
+#include <string>
 
 /* Forward-declarations for minor dependencies */
 namespace sdbusplus
@@ -65,6 +67,9 @@ class PropertiesChanged
     template <typename... Args>
     void read(Args&&... args);
 
+    /* The new value of a boolean property, if the signal carries it */
+    std::optional<bool> findBool(const std::string& property);
+
   private:
     sdbusplus::message::message& message;
 };
@@ -7,6 +7,10 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <mutex>
 #include <sstream>
 
 PHOSPHOR_LOG2_USING;
@@ -22,23 +26,25 @@ bool BasicNVMeDrive::isBasicEndpointPresent(const SysfsI2CBus& bus)
     return i2c::isDeviceResponsive(bus, BasicNVMeDrive::endpointAddress);
 }
 
-std::vector<uint8_t> BasicNVMeDrive::fetchMetadata(const SysfsI2CBus& bus)
+std::shared_ptr<const BasicNVMeDrive::Record>
+    BasicNVMeDrive::fetchRecord(const SysfsI2CBus& bus)
 {
-    std::vector<uint8_t> data;
+    Metadata buffer{};
 
-    debug("Reading metadata for drive on bus {I2C_DEV_PATH}", "I2C_DEV_PATH",
-          bus.getBusDevice().string());
+    debug("Reading metadata for drive on bus {I2C_BUS}", "I2C_BUS",
+          bus.getAddress());
 
-    i2c::oneshotSMBusBlockRead(bus, BasicNVMeDrive::endpointAddress,
-                               BasicNVMeDrive::vendorMetadataOffset, data);
+    std::size_t length = i2c::oneshotSMBusBlockRead(
+        bus, BasicNVMeDrive::endpointAddress,
+        BasicNVMeDrive::vendorMetadataOffset, buffer);
 
-    assert(data.size() >= 2);
+    assert(length >= 2);
 
-    return data;
+    return findRecord(bus, std::span(buffer).first(length));
 }
 
 std::vector<uint8_t>
-    BasicNVMeDrive::extractManufacturer(const std::vector<uint8_t>& metadata)
+    BasicNVMeDrive::extractManufacturer(std::span<const uint8_t> metadata)
 {
     std::vector<uint8_t> manufacturer;
     if (metadata.size() >= 2)
@@ -55,7 +61,7 @@ std::vector<uint8_t>
 }
 
 std::vector<uint8_t>
-    BasicNVMeDrive::extractSerial(const std::vector<uint8_t>& metadata)
+    BasicNVMeDrive::extractSerial(std::span<const uint8_t> metadata)
 {
     std::vector<uint8_t> serial;
     if (metadata.size() >= 2)
@@ -71,62 +77,139 @@ std::vector<uint8_t>
     return serial;
 }
 
-BasicNVMeDrive::BasicNVMeDrive(std::string&& path) : inventoryPath(path) {}
+std::shared_ptr<const BasicNVMeDrive::Record>
+    BasicNVMeDrive::findRecord(const SysfsI2CBus& bus,
+                               std::span<const uint8_t> metadata)
+{
+    /* Bounded by the number of drive buses */
+    static std::mutex lock;
+    static std::map<int, std::shared_ptr<const Record>> records;
 
-BasicNVMeDrive::BasicNVMeDrive(const SysfsI2CBus& bus, std::string&& path) :
-    BasicNVMeDrive(bus, std::move(path), BasicNVMeDrive::fetchMetadata(bus))
-{}
+    metadata = metadata.first(std::min(metadata.size(), Metadata().size()));
+
+    std::scoped_lock guard(lock);
+    std::shared_ptr<const Record>& found = records[bus.getAddress()];
+    if (found &&
+        std::ranges::equal(std::span(found->metadata).first(found->length),
+                           metadata))
+    {
+        return found;
+    }
+
+    Metadata copy{};
+    std::ranges::copy(metadata, copy.begin());
+    found = std::make_shared<const Record>(
+        Record{copy, metadata.size(),
+               inventory::interfaces::I2CDevice(bus.getAddress(),
+                                                eepromAddress),
+               inventory::interfaces::VINI(
+                   std::vector<uint8_t>({'N', 'V', 'M', 'e'}),
+                   BasicNVMeDrive::extractSerial(metadata)),
+               BasicNVMeDrive::extractManufacturer(metadata),
+               BasicNVMeDrive::extractSerial(metadata),
+               BasicNVMeDrive::fingerprint(metadata)});
 
-BasicNVMeDrive::BasicNVMeDrive(const SysfsI2CBus& bus, std::string&& path,
-                               const std::vector<uint8_t>&& metadata) :
-    NVMeDrive(), inventoryPath(path), basic(bus.getAddress(), eepromAddress),
-    vini(std::vector<uint8_t>({'N', 'V', 'M', 'e'}),
-         BasicNVMeDrive::extractSerial(metadata)),
-    manufacturer(BasicNVMeDrive::extractManufacturer(metadata)),
-    serial(BasicNVMeDrive::extractSerial(metadata))
-{
     std::stringstream ms;
     ms << std::noskipws << " ";
-    for (auto v : manufacturer.value())
+    for (auto v : found->manufacturer)
     {
         ms << std::hex << (unsigned int)v << " ";
     }
 
-    std::string prettySerial(serial.value().begin(), serial.value().end());
+    std::string prettySerial(found->serial.begin(), found->serial.end());
 
     info(
         "Instantiated drive for device on bus {I2C_BUS} with manufacturer [{DRIVE_MANUFACTURER_ID}] and serial [{DRIVE_SERIAL}]",
         "I2C_BUS", bus.getAddress(), "DRIVE_MANUFACTURER_ID", ms.str(),
         "DRIVE_SERIAL", prettySerial);
+
+    return found;
+}
+
+/* Only the interfaces' removal properties are needed to cold-unplug */
+const std::shared_ptr<const BasicNVMeDrive::Record>&
+    BasicNVMeDrive::absentRecord()
+{
+    static const std::shared_ptr<const Record> absent =
+        std::make_shared<const Record>(Record{{}, 0, {}, {}, {}, {}, 0});
+
+    return absent;
+}
+
+BasicNVMeDrive::BasicNVMeDrive(const std::string& path) :
+    inventoryPath(path), record(absentRecord())
+{}
+
+BasicNVMeDrive::BasicNVMeDrive(const SysfsI2CBus& bus,
+                               const std::string& path) :
+    inventoryPath(path), record(fetchRecord(bus))
+{}
+
+BasicNVMeDrive::BasicNVMeDrive(const SysfsI2CBus& bus, const std::string& path,
+                               std::span<const uint8_t> metadata) :
+    inventoryPath(path), record(findRecord(bus, metadata))
+{}
+
+BasicNVMeDrive::BasicNVMeDrive(const std::string& path, uint32_t fingerprint) :
+    inventoryPath(path), record(absentRecord()), adopted(fingerprint)
+{}
+
+uint32_t BasicNVMeDrive::fingerprint(std::span<const uint8_t> metadata)
+{
+    /* FNV-1a, with 0 reserved for FRUs that have no identity */
+    uint32_t hash = 2166136261U;
+
+    for (uint8_t byte : metadata)
+    {
+        hash ^= byte;
+        hash *= 16777619U;
+    }
+
+    return hash == 0 ? 1 : hash;
+}
+
+uint32_t BasicNVMeDrive::getFingerprint() const
+{
+    return adopted != 0 ? adopted : record->fingerprint;
+}
+
+bool BasicNVMeDrive::verify(const SysfsI2CBus& bus)
+{
+    const uint32_t expected = getFingerprint();
+
+    record = fetchRecord(bus);
+    adopted = 0;
+
+    return record->fingerprint == expected;
 }
 
-std::string BasicNVMeDrive::getInventoryPath() const
+const std::string& BasicNVMeDrive::getInventoryPath() const
 {
     return inventoryPath;
 }
 
 void BasicNVMeDrive::addToInventory(Inventory* inventory)
 {
-    std::string path = getInventoryPath();
+    const std::string& path = getInventoryPath();
 
-    inventory->add(path, basic);
-    inventory->add(path, vini);
+    inventory->add(path, record->basic);
+    inventory->add(path, record->vini);
 }
 
 void BasicNVMeDrive::removeFromInventory(Inventory* inventory)
 {
-    std::string path = getInventoryPath();
+    const std::string& path = getInventoryPath();
 
-    inventory->remove(path, vini);
-    inventory->remove(path, basic);
+    inventory->remove(path, record->vini);
+    inventory->remove(path, record->basic);
 }
 
 const std::vector<uint8_t>& BasicNVMeDrive::getManufacturer() const
 {
-    return manufacturer.value();
+    return record->manufacturer;
 }
 
 const std::vector<uint8_t>& BasicNVMeDrive::getSerial() const
 {
-    return serial.value();
+    return record->serial;
 }
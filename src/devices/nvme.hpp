@@ -2,35 +2,63 @@
 /* Copyright IBM Corp. 2021 */
 #pragma once
 
+#include "i2c.hpp"
 #include "inventory.hpp"
 #include "platform.hpp"
+#include "power.hpp"
 #include "sysfs/i2c.hpp"
 
 #include <gpiod.hpp>
 
 #include <array>
+#include <memory>
 #include <optional>
+#include <span>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 class Inventory;
 
 class NVMeDrive
 {
+  public:
+    /* Ride out transient endpoint NAKs rather than churn the inventory */
+    static constexpr DebouncePolicy debounce{2, 3};
+    static constexpr const char* pollClass = "drive";
+
   protected:
     /* FRU Information Device, NVMe Storage Device (non-Carrier) */
     static constexpr int eepromAddress = 0x53;
 };
 
+/*
+ * The inventory interfaces of a drive are derived from the metadata its
+ * endpoint reports. They're kept per bus while the metadata is unchanged, so
+ * reseating the same drive, or its presence flapping, reuses them rather than
+ * rebuilding them on the heap. The inventory path must outlive the drive, so
+ * temporaries are rejected.
+ *
+ * The drive's fingerprint is a hash of the metadata. A drive adopted from a
+ * previous instance of the daemon holds only the fingerprint it was published
+ * with until verify() reads the metadata back.
+ */
 class BasicNVMeDrive : public NVMeDrive, FRU
 {
   public:
     static bool isBasicEndpointPresent(const SysfsI2CBus& bus);
 
-    explicit BasicNVMeDrive(std::string&& path);
-    BasicNVMeDrive(const SysfsI2CBus& bus, std::string&& path);
+    explicit BasicNVMeDrive(const std::string& path);
+    BasicNVMeDrive(const SysfsI2CBus& bus, const std::string& path);
+    BasicNVMeDrive(const SysfsI2CBus& bus, const std::string& path,
+                   std::span<const uint8_t> metadata);
+    BasicNVMeDrive(const std::string& path, uint32_t fingerprint);
+    /* The drive keeps a reference to the path, so a temporary would dangle */
+    explicit BasicNVMeDrive(std::string&& path) = delete;
+    BasicNVMeDrive(std::string&& path, uint32_t fingerprint) = delete;
+    BasicNVMeDrive(const SysfsI2CBus& bus, std::string&& path) = delete;
     BasicNVMeDrive(const SysfsI2CBus& bus, std::string&& path,
-                   const std::vector<uint8_t>&& metadata);
+                   std::span<const uint8_t> metadata) = delete;
     BasicNVMeDrive(const BasicNVMeDrive& other) = delete;
     BasicNVMeDrive(BasicNVMeDrive&& other) = delete;
     virtual ~BasicNVMeDrive() = default;
@@ -39,30 +67,96 @@ class BasicNVMeDrive : public NVMeDrive, FRU
     BasicNVMeDrive& operator=(BasicNVMeDrive&& other) = delete;
 
     /* FRU */
-    std::string getInventoryPath() const override;
+    const std::string& getInventoryPath() const override;
     void addToInventory(Inventory* inventory) override;
     void removeFromInventory(Inventory* inventory) override;
 
+    static uint32_t fingerprint(std::span<const uint8_t> metadata);
+    uint32_t getFingerprint() const;
+
+    /* Returns true if the metadata matches the fingerprint adopted with */
+    bool verify(const SysfsI2CBus& bus);
+
   protected:
     const std::vector<uint8_t>& getManufacturer() const;
     const std::vector<uint8_t>& getSerial() const;
 
   private:
-    static std::vector<uint8_t> fetchMetadata(const SysfsI2CBus& bus);
+    using Metadata = std::array<uint8_t, i2c::smbusBlockMax>;
+
+    struct Record
+    {
+        Metadata metadata;
+        std::size_t length;
+        inventory::interfaces::I2CDevice basic;
+        inventory::interfaces::VINI vini;
+        std::vector<uint8_t> manufacturer;
+        std::vector<uint8_t> serial;
+        uint32_t fingerprint;
+    };
+
+    static const std::shared_ptr<const Record>& absentRecord();
+    static std::shared_ptr<const Record> fetchRecord(const SysfsI2CBus& bus);
     static std::vector<uint8_t>
-        extractManufacturer(const std::vector<uint8_t>& metadata);
+        extractManufacturer(std::span<const uint8_t> metadata);
     static std::vector<uint8_t>
-        extractSerial(const std::vector<uint8_t>& metadata);
+        extractSerial(std::span<const uint8_t> metadata);
+    static std::shared_ptr<const Record>
+        findRecord(const SysfsI2CBus& bus, std::span<const uint8_t> metadata);
 
     static constexpr int endpointAddress = 0x6a;
     static constexpr int vendorMetadataOffset = 0x08;
 
-    const std::string inventoryPath;
-    const inventory::interfaces::I2CDevice basic;
-    const inventory::interfaces::VINI vini;
+    const std::string& inventoryPath;
+    std::shared_ptr<const Record> record;
+    uint32_t adopted = 0;
+};
+
+/*
+ * Reports presence as the response of the basic NVMe management endpoint.
+ * The endpoint is unpowered with the host, so the last response stands until
+ * the host is powered again.
+ */
+class NVMeEndpointPresence
+{
+  public:
+    NVMeEndpointPresence() = delete;
+    explicit NVMeEndpointPresence(SysfsI2CBus bus) :
+        bus(std::move(bus)), present(false),
+        adapter(SysfsI2CTopology::instance().findRootAdapter(
+            this->bus.getAddress()))
+    {}
+
+    bool operator()()
+    {
+        if (HostPower::instance().isOn())
+        {
+            present = BasicNVMeDrive::isBasicEndpointPresent(bus);
+        }
+
+        return present;
+    }
+
+    /* BusProbe */
+    int getBus() const
+    {
+        return bus.getAddress();
+    }
+
+    int getAdapter() const
+    {
+        return adapter;
+    }
 
-    std::optional<std::vector<uint8_t>> manufacturer;
-    std::optional<std::vector<uint8_t>> serial;
+    bool usesBus() const
+    {
+        return HostPower::instance().isOn();
+    }
+
+  private:
+    SysfsI2CBus bus;
+    bool present;
+    int adapter;
 };
 
 class NVMeDrivePresence
@@ -70,7 +164,9 @@ class NVMeDrivePresence
   public:
     NVMeDrivePresence() = delete;
     NVMeDrivePresence(gpiod::line&& line, SysfsI2CBus bus) :
-        line(line), bus(std::move(bus)), haveEndpoint(false)
+        line(line), bus(std::move(bus)), haveEndpoint(false),
+        adapter(SysfsI2CTopology::instance().findRootAdapter(
+            this->bus.getAddress()))
     {}
 
     bool operator()()
@@ -84,7 +180,8 @@ class NVMeDrivePresence
             return false;
         }
 
-        if (!haveEndpoint)
+        // Only the GPIO is meaningful while the host is off
+        if (!haveEndpoint && HostPower::instance().isOn())
         {
             haveEndpoint = BasicNVMeDrive::isBasicEndpointPresent(bus);
         }
@@ -92,8 +189,26 @@ class NVMeDrivePresence
         return haveEndpoint;
     }
 
+    /* BusProbe */
+    int getBus() const
+    {
+        return bus.getAddress();
+    }
+
+    int getAdapter() const
+    {
+        return adapter;
+    }
+
+    /* Conservatively assume the GPIO reports the drive present */
+    bool usesBus() const
+    {
+        return !haveEndpoint && HostPower::instance().isOn();
+    }
+
   private:
     gpiod::line line;
     SysfsI2CBus bus;
     bool haveEndpoint;
+    int adapter;
 };
@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "devices/vpd.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <system_error>
+
+PHOSPHOR_LOG2_USING;
+
+static constexpr char largeResourceTag = static_cast<char>(0x84);
+
+/* The records used for identification live early in the image */
+static constexpr std::size_t maxImageSize = 4096;
+
+static std::size_t readLength(std::span<const char> data, std::size_t width)
+{
+    std::size_t length = static_cast<unsigned char>(data[0]);
+
+    if (width == 2)
+    {
+        length |= static_cast<std::size_t>(static_cast<unsigned char>(data[1]))
+                  << 8;
+    }
+
+    return length;
+}
+
+static std::optional<std::string>
+    findRecordKeyword(std::span<const char> data, std::string_view keyword)
+{
+    std::size_t pos = 0;
+
+    while (pos + 3 <= data.size())
+    {
+        std::string_view name(&data[pos], 2);
+        std::size_t width = name.starts_with('#') ? 2 : 1;
+
+        if (name == "PF" || pos + 2 + width > data.size())
+        {
+            break;
+        }
+
+        std::size_t length = readLength(data.subspan(pos + 2), width);
+        std::size_t value = pos + 2 + width;
+
+        if (value + length > data.size())
+        {
+            break;
+        }
+
+        if (name == keyword)
+        {
+            return std::string(&data[value], length);
+        }
+
+        pos = value + length;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::string> vpd::findKeyword(std::span<const char> image,
+                                            std::string_view record,
+                                            std::string_view keyword)
+{
+    /* Tag, length, then 'RT', its length and the record name */
+    const std::size_t header = 3 + 3 + record.size();
+
+    for (std::size_t pos = 0; pos + header <= image.size(); pos++)
+    {
+        if (image[pos] != largeResourceTag)
+        {
+            continue;
+        }
+
+        std::string_view rt(&image[pos + 3], 3 + record.size());
+        if (!rt.starts_with("RT") ||
+            static_cast<unsigned char>(rt[2]) != record.size() ||
+            rt.substr(3) != record)
+        {
+            continue;
+        }
+
+        std::size_t length = readLength(image.subspan(pos + 1), 2);
+        std::size_t end = std::min(pos + 3 + length, image.size());
+        if (end < pos + header)
+        {
+            return std::nullopt;
+        }
+
+        return findRecordKeyword(
+            image.subspan(pos + header, end - pos - header), keyword);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::string> vpd::readCCIN(const SysfsEEPROM& eeprom)
+{
+    std::array<char, maxImageSize> image{};
+    std::size_t len = eeprom.read(image);
+
+    std::optional<std::string> ccin =
+        findKeyword({image.data(), len}, "VINI", "CC");
+    if (!ccin)
+    {
+        debug("No CCIN found in '{SYSFS_PATH}'", "SYSFS_PATH",
+              eeprom.getPath().string());
+    }
+
+    return ccin;
+}
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include "sysfs/eeprom.hpp"
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+/*
+ * Just enough of the IBM IPZ VPD format to identify a card from its local
+ * EEPROM without waiting for the VPD parsers to publish it to inventory.
+ *
+ * A record is a large resource (tag 0x84, little-endian 16-bit length) whose
+ * first keyword is 'RT' naming the record. Keywords are a two character name,
+ * a length byte (two bytes for names starting with '#'), then the value.
+ */
+namespace vpd
+{
+std::optional<std::string> findKeyword(std::span<const char> image,
+                                       std::string_view record,
+                                       std::string_view keyword);
+
+/* Read the card's CCIN ('CC' in the 'VINI' record) */
+std::optional<std::string> readCCIN(const SysfsEEPROM& eeprom);
+} // namespace vpd
@@ -22,13 +22,26 @@ void EnvironmentManager::enrollEnvironment(ExecutionEnvironment* env)
 void EnvironmentManager::run(PlatformManager& pm, Notifier& notifier,
                              Inventory* inventory)
 {
-    for (auto& env : environments)
+    ExecutionEnvironment* probed = nullptr;
+
     {
-        if (env->probe())
+        StartupReport::Phase phase =
+            notifier.startupPhase("Probing execution environment");
+
+        for (auto& env : environments)
         {
-            return env->run(pm, notifier, inventory);
+            if (env->probe())
+            {
+                probed = env;
+                break;
+            }
         }
     }
+
+    if (probed != nullptr)
+    {
+        probed->run(pm, notifier, inventory);
+    }
 }
 
 #if defined(__arm__)
@@ -76,8 +76,19 @@ bool isDeviceResponsive(const SysfsI2CBus& bus, int address)
     return rc >= 0;
 }
 
+static_assert(smbusBlockMax == I2C_SMBUS_BLOCK_MAX);
+
 void oneshotSMBusBlockRead(const SysfsI2CBus& bus, int address, uint8_t command,
                            std::vector<uint8_t>& data)
+{
+    data.resize(smbusBlockMax);
+    data.resize(oneshotSMBusBlockRead(
+        bus, address, command, std::span<uint8_t, smbusBlockMax>(data)));
+}
+
+std::size_t oneshotSMBusBlockRead(const SysfsI2CBus& bus, int address,
+                                  uint8_t command,
+                                  std::span<uint8_t, smbusBlockMax> data)
 {
     fs::path path = bus.getBusDevice();
     FileDescriptor fd(path);
@@ -113,7 +124,6 @@ void oneshotSMBusBlockRead(const SysfsI2CBus& bus, int address, uint8_t command,
         throw std::system_category().default_error_condition(errno);
     }
 
-    data.resize(255);
     rc = ::i2c_smbus_read_block_data(fd.descriptor(), command, data.data());
     if (rc < 0)
     {
@@ -125,6 +135,7 @@ void oneshotSMBusBlockRead(const SysfsI2CBus& bus, int address, uint8_t command,
     }
     debug("Read {BLOCK_READ_LENGTH} bytes of block data", "BLOCK_READ_LENGTH",
           rc);
-    data.resize(rc);
+
+    return static_cast<std::size_t>(rc);
 }
 } // namespace i2c
@@ -4,11 +4,20 @@
 
 #include "sysfs/i2c.hpp"
 
+#include <cstddef>
+#include <span>
 #include <vector>
 
 namespace i2c
 {
+/* The largest payload of an SMBus block read, I2C_SMBUS_BLOCK_MAX */
+constexpr std::size_t smbusBlockMax = 32;
+
 bool isDeviceResponsive(const SysfsI2CBus& bus, int address);
 void oneshotSMBusBlockRead(const SysfsI2CBus& bus, int address, uint8_t command,
                            std::vector<uint8_t>& data);
+/* Returns the length of the block read into data */
+std::size_t oneshotSMBusBlockRead(const SysfsI2CBus& bus, int address,
+                                  uint8_t command,
+                                  std::span<uint8_t, smbusBlockMax> data);
 } // namespace i2c
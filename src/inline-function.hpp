@@ -0,0 +1,155 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, std::size_t Capacity = 4 * sizeof(void*)>
+class InlineFunction;
+
+/*
+ * A std::function replacement that stores its target in place. Targets that
+ * don't fit in the capacity fail to compile rather than fall back to the heap,
+ * so constructing, copying and invoking an InlineFunction never allocates.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class InlineFunction<R(Args...), Capacity>
+{
+  public:
+    InlineFunction() : ops(nullptr), storage() {}
+
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, InlineFunction> &&
+                 std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    // NOLINTNEXTLINE(bugprone-forwarding-reference-overload)
+    InlineFunction(F&& f) : ops(&Ops<std::decay_t<F>>::table), storage()
+    {
+        using Target = std::decay_t<F>;
+
+        static_assert(sizeof(Target) <= Capacity,
+                      "Target exceeds the InlineFunction capacity");
+        static_assert(alignof(Target) <= alignof(std::max_align_t),
+                      "Target is over-aligned for InlineFunction");
+
+        new (storage.data()) Target(std::forward<F>(f));
+    }
+
+    InlineFunction(const InlineFunction& other) :
+        ops(other.ops), storage()
+    {
+        if (ops != nullptr)
+        {
+            ops->copy(storage.data(), other.storage.data());
+        }
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept :
+        ops(other.ops), storage()
+    {
+        if (ops != nullptr)
+        {
+            ops->move(storage.data(), other.storage.data());
+        }
+    }
+
+    ~InlineFunction()
+    {
+        reset();
+    }
+
+    InlineFunction& operator=(const InlineFunction& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            ops = other.ops;
+            if (ops != nullptr)
+            {
+                ops->copy(storage.data(), other.storage.data());
+            }
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            ops = other.ops;
+            if (ops != nullptr)
+            {
+                ops->move(storage.data(), other.storage.data());
+            }
+        }
+        return *this;
+    }
+
+    R operator()(Args... args)
+    {
+        if (ops == nullptr)
+        {
+            throw std::bad_function_call();
+        }
+
+        return ops->invoke(storage.data(), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops != nullptr;
+    }
+
+  private:
+    struct Table
+    {
+        R (*invoke)(void* target, Args&&... args);
+        void (*copy)(void* to, const void* from);
+        void (*move)(void* to, void* from);
+        void (*destroy)(void* target);
+    };
+
+    template <typename Target>
+    struct Ops
+    {
+        static R invoke(void* target, Args&&... args)
+        {
+            return std::invoke(*static_cast<Target*>(target),
+                               std::forward<Args>(args)...);
+        }
+
+        static void copy(void* to, const void* from)
+        {
+            new (to) Target(*static_cast<const Target*>(from));
+        }
+
+        static void move(void* to, void* from)
+        {
+            new (to) Target(std::move(*static_cast<Target*>(from)));
+        }
+
+        static void destroy(void* target)
+        {
+            static_cast<Target*>(target)->~Target();
+        }
+
+        static constexpr Table table = {invoke, copy, move, destroy};
+    };
+
+    void reset()
+    {
+        if (ops != nullptr)
+        {
+            ops->destroy(storage.data());
+            ops = nullptr;
+        }
+    }
+
+    const Table* ops;
+    alignas(std::max_align_t) std::array<std::byte, Capacity> storage;
+};
@@ -4,11 +4,14 @@
 
 #include "dbus.hpp"
 
+#include <condition_variable>
 #include <exception>
 #include <functional>
 #include <list>
 #include <map>
+#include <mutex>
 #include <optional>
+#include <ostream>
 #include <set>
 #include <span>
 #include <string>
@@ -41,6 +44,10 @@ static constexpr auto INVENTORY_ITEM_IFACE =
 static constexpr auto INVENTORY_ITEM_PCIESLOT_IFACE =
     "xyz.openbmc_project.Inventory.Item.PCIeSlot";
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+static constexpr auto INVENTORY_DECORATOR_ASSET_IFACE =
+    "xyz.openbmc_project.Inventory.Decorator.Asset";
+
 // https://github.com/openbmc/phosphor-dbus-interfaces/blob/08baf48ad5f15774d393fbbf4e9479a0ef3e82d0/yaml/xyz/openbmc_project/Inventory/Decorator/I2CDevice.interface.yaml
 // NOLINTNEXTLINE(readability-identifier-naming)
 static constexpr auto INVENTORY_DECORATOR_I2CDEVICE_IFACE =
@@ -185,6 +192,7 @@ class Inventory
 
     virtual void migrate(std::span<inventory::Migration*>&& migrations) = 0;
 
+    /* Listen for changes to the properties of interface on the item at path */
     virtual std::weak_ptr<dbus::PropertiesChangedListener>
         addPropertiesChangedListener(
             const std::string& path, const std::string& interface,
@@ -193,9 +201,9 @@ class Inventory
         std::weak_ptr<dbus::PropertiesChangedListener> listener) = 0;
 
     virtual void add(const std::string& path,
-                     inventory::interfaces::Interface iface) = 0;
+                     const inventory::interfaces::Interface& iface) = 0;
     virtual void remove(const std::string& path,
-                        inventory::interfaces::Interface iface) = 0;
+                        const inventory::interfaces::Interface& iface) = 0;
     virtual void markPresent(const std::string& path) = 0;
     virtual void markAbsent(const std::string& path) = 0;
     virtual bool isPresent(const std::string& path) = 0;
@@ -214,6 +222,13 @@ class InventoryManager : public Inventory
     InventoryManager& operator=(const InventoryManager& other) = delete;
     InventoryManager& operator=(InventoryManager&& other) = delete;
 
+    /*
+     * Fetch the inventory objects ahead of the next migrate() so the
+     * round-trip overlaps other start-up work. The migrations consume the
+     * snapshot; if the prefetch fails they fetch the objects themselves.
+     */
+    void prefetch();
+
     void migrate(std::span<inventory::Migration*>&& migrations) override;
 
     /* Inventory */
@@ -223,9 +238,9 @@ class InventoryManager : public Inventory
     void removePropertiesChangedListener(
         std::weak_ptr<dbus::PropertiesChangedListener> listener) override;
     void add(const std::string& path,
-             inventory::interfaces::Interface iface) override;
+             const inventory::interfaces::Interface& iface) override;
     void remove(const std::string& path,
-                inventory::interfaces::Interface iface) override;
+                const inventory::interfaces::Interface& iface) override;
     void markPresent(const std::string& path) override;
     void markAbsent(const std::string& path) override;
     bool isPresent(const std::string& path) override;
@@ -237,8 +252,59 @@ class InventoryManager : public Inventory
 
     static std::string extractItemPath(const std::string& objectPath);
 
+    /* The inventory objects keyed by item path */
+    std::map<std::string, inventory::ObjectType> fetchObjects();
+
     sdbusplus::bus::bus& dbus;
     std::set<std::shared_ptr<dbus::PropertiesChangedListener>> listeners;
+    std::optional<std::map<std::string, inventory::ObjectType>> snapshot;
+};
+
+/*
+ * Stands in for the inventory manager when the daemon is run with --dry-run.
+ * The D-Bus operations that would have been made are written to the stream,
+ * and presence queries are answered from the operations recorded so far.
+ */
+class RecordingInventory : public Inventory
+{
+  public:
+    RecordingInventory() = delete;
+    explicit RecordingInventory(std::ostream& out);
+    RecordingInventory(const RecordingInventory& other) = delete;
+    RecordingInventory(RecordingInventory&& other) = delete;
+    virtual ~RecordingInventory() = default;
+
+    RecordingInventory& operator=(const RecordingInventory& other) = delete;
+    RecordingInventory& operator=(RecordingInventory&& other) = delete;
+
+    void migrate(std::span<inventory::Migration*>&& migrations) override;
+
+    /* Inventory */
+    std::weak_ptr<dbus::PropertiesChangedListener> addPropertiesChangedListener(
+        const std::string& path, const std::string& interface,
+        std::function<void(dbus::PropertiesChanged&& props)> callback) override;
+    void removePropertiesChangedListener(
+        std::weak_ptr<dbus::PropertiesChangedListener> listener) override;
+    void add(const std::string& path,
+             const inventory::interfaces::Interface& iface) override;
+    void remove(const std::string& path,
+                const inventory::interfaces::Interface& iface) override;
+    void markPresent(const std::string& path) override;
+    void markAbsent(const std::string& path) override;
+    bool isPresent(const std::string& path) override;
+    bool isModel(const std::string& path, const std::string& model) override;
+
+    std::size_t getOperationCount();
+
+  private:
+    void record(const std::string& operation);
+    void updateObject(const std::string& path,
+                      const inventory::ObjectType& updates);
+
+    std::ostream& out;
+    std::mutex lock;
+    std::size_t operations;
+    std::map<std::string, bool> presentCache;
 };
 
 /* Unifies the split we have with WilliwakasNVMeDrive and FlettNVMeDrive */
@@ -267,9 +333,9 @@ class PublishWhenPresentInventoryDecorator : public Inventory
     void removePropertiesChangedListener(
         std::weak_ptr<dbus::PropertiesChangedListener> listener) override;
     void add(const std::string& path,
-             inventory::interfaces::Interface iface) override;
+             const inventory::interfaces::Interface& iface) override;
     void remove(const std::string& path,
-                inventory::interfaces::Interface iface) override;
+                const inventory::interfaces::Interface& iface) override;
     void markPresent(const std::string& path) override;
     void markAbsent(const std::string& path) override;
     bool isPresent(const std::string& path) override;
@@ -282,3 +348,54 @@ class PublishWhenPresentInventoryDecorator : public Inventory
         objectCache;
     std::map<std::string, bool> presentCache;
 };
+
+/*
+ * Serialises access to the inventory for work executed on a WorkPool. Access
+ * can be held back while migrations are applied, so hardware discovery can
+ * proceed concurrently with the migrations and only waits for them once it
+ * needs the inventory.
+ */
+class SynchronisedInventoryDecorator : public Inventory
+{
+  public:
+    SynchronisedInventoryDecorator() = delete;
+    explicit SynchronisedInventoryDecorator(Inventory* inventory);
+    SynchronisedInventoryDecorator(
+        const SynchronisedInventoryDecorator& other) = delete;
+    SynchronisedInventoryDecorator(SynchronisedInventoryDecorator&& other) =
+        delete;
+    virtual ~SynchronisedInventoryDecorator() = default;
+
+    SynchronisedInventoryDecorator&
+        operator=(const SynchronisedInventoryDecorator& other) = delete;
+    SynchronisedInventoryDecorator&
+        operator=(SynchronisedInventoryDecorator&& other) = delete;
+
+    /* Hold all but migrations until the next migration completes */
+    void hold();
+
+    void migrate(std::span<inventory::Migration*>&& migrations) override;
+
+    /* Inventory */
+    std::weak_ptr<dbus::PropertiesChangedListener> addPropertiesChangedListener(
+        const std::string& path, const std::string& interface,
+        std::function<void(dbus::PropertiesChanged&& props)> callback) override;
+    void removePropertiesChangedListener(
+        std::weak_ptr<dbus::PropertiesChangedListener> listener) override;
+    void add(const std::string& path,
+             const inventory::interfaces::Interface& iface) override;
+    void remove(const std::string& path,
+                const inventory::interfaces::Interface& iface) override;
+    void markPresent(const std::string& path) override;
+    void markAbsent(const std::string& path) override;
+    bool isPresent(const std::string& path) override;
+    bool isModel(const std::string& path, const std::string& model) override;
+
+  private:
+    std::unique_lock<std::mutex> acquire();
+
+    Inventory* inventory;
+    std::mutex lock;
+    std::condition_variable released;
+    bool held;
+};
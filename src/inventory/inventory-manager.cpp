@@ -36,27 +36,51 @@ static constexpr auto DBUS_PROPERTY_IFACE = "org.freedesktop.DBus.Properties";
 static constexpr auto DBUS_OBJECTMANAGER_IFACE =
     "org.freedesktop.DBus.ObjectManager";
 
-// NOLINTNEXTLINE(readability-identifier-naming)
-static constexpr auto INVENTORY_DECORATOR_ASSET_IFACE =
-    "xyz.openbmc_project.Inventory.Decorator.Asset";
-
 using namespace inventory;
 using namespace dbus;
 
-void InventoryManager::migrate(std::span<Migration*>&& migrations)
+std::map<std::string, ObjectType> InventoryManager::fetchObjects()
 {
     auto call =
         dbus.new_method_call(INVENTORY_BUS_NAME, INVENTORY_MANAGER_OBJECT,
                              DBUS_OBJECTMANAGER_IFACE, "GetManagedObjects");
+    std::map<sdbusplus::message::object_path, ObjectType> objects;
+    auto reply = dbus.call(call);
+    reply.read(objects);
+
+    std::map<std::string, ObjectType> items;
+    for (auto& [objectPath, object] : objects)
+    {
+        items.emplace(extractItemPath(objectPath.str), std::move(object));
+    }
+
+    return items;
+}
+
+void InventoryManager::prefetch()
+{
     try
     {
-        std::map<sdbusplus::message::object_path, ObjectType> objects;
-        auto reply = dbus.call(call);
-        reply.read(objects);
+        snapshot = fetchObjects();
+    }
+    catch (const sdbusplus::exception::exception& ex)
+    {
+        warning(
+            "Failed to prefetch inventory objects, deferring to migration: {EXCEPTION_DESCRIPTION}",
+            "EXCEPTION_DESCRIPTION", ex);
+    }
+}
+
+void InventoryManager::migrate(std::span<Migration*>&& migrations)
+{
+    try
+    {
+        std::map<std::string, ObjectType> objects =
+            snapshot ? std::move(*snapshot) : fetchObjects();
+        snapshot.reset();
 
-        for (const auto& [objectPath, object] : objects)
+        for (const auto& [itemPath, object] : objects)
         {
-            const auto itemPath = extractItemPath({objectPath});
 
             for (auto* migration : migrations)
             {
@@ -110,7 +134,10 @@ std::weak_ptr<PropertiesChangedListener>
         const std::string& path, const std::string& interface,
         std::function<void(PropertiesChanged&&)> callback)
 {
-    auto pcl = sharedPropertiesChangedListener(dbus, path, interface, callback);
+    std::string absolute = std::string("/xyz/openbmc_project/inventory") + path;
+
+    auto pcl = sharedPropertiesChangedListener(dbus, absolute, interface,
+                                               callback);
     return *(listeners.insert(pcl).first);
 }
 
@@ -152,7 +179,7 @@ void InventoryManager::updateObject(const std::string& path,
 }
 
 void InventoryManager::add(const std::string& path,
-                           const interfaces::Interface iface)
+                           const interfaces::Interface& iface)
 {
     ObjectType updates;
 
@@ -162,7 +189,7 @@ void InventoryManager::add(const std::string& path,
 }
 
 void InventoryManager::remove(const std::string& path,
-                              const interfaces::Interface iface)
+                              const interfaces::Interface& iface)
 {
     ObjectType updates;
 
@@ -0,0 +1,159 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "inventory.hpp"
+
+#include <sstream>
+#include <type_traits>
+#include <variant>
+
+using namespace inventory;
+using namespace dbus;
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static constexpr auto INVENTORY_MANAGER_OBJECT =
+    "/xyz/openbmc_project/inventory";
+
+static void formatProperty(std::ostream& out, const PropertyType& value)
+{
+    std::visit(
+        [&out](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                out << (v ? "true" : "false");
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                out << '"' << v << '"';
+            }
+            else if constexpr (std::is_same_v<T, std::vector<uint8_t>>)
+            {
+                out << "[" << v.size() << " bytes]";
+            }
+            else
+            {
+                out << v;
+            }
+        },
+        value);
+}
+
+RecordingInventory::RecordingInventory(std::ostream& out) :
+    out(out), operations(0)
+{}
+
+void RecordingInventory::record(const std::string& operation)
+{
+    std::lock_guard guard(lock);
+    out << operation << '\n';
+    operations++;
+}
+
+std::size_t RecordingInventory::getOperationCount()
+{
+    std::lock_guard guard(lock);
+    return operations;
+}
+
+void RecordingInventory::migrate(
+    [[maybe_unused]] std::span<Migration*>&& migrations)
+{
+    /* There are no inventory objects to migrate */
+    record(std::string("GetManagedObjects ") + INVENTORY_MANAGER_OBJECT);
+}
+
+std::weak_ptr<PropertiesChangedListener>
+    RecordingInventory::addPropertiesChangedListener(
+        const std::string& path, const std::string& interface,
+        [[maybe_unused]] std::function<void(PropertiesChanged&&)> callback)
+{
+    record("AddMatch PropertiesChanged " +
+           std::string(INVENTORY_MANAGER_OBJECT) + path + " " + interface);
+
+    /* No properties will change, so there's nothing to listen to */
+    return {};
+}
+
+void RecordingInventory::removePropertiesChangedListener(
+    [[maybe_unused]] std::weak_ptr<PropertiesChangedListener> listener)
+{
+    record("RemoveMatch PropertiesChanged");
+}
+
+void RecordingInventory::updateObject(const std::string& path,
+                                      const ObjectType& updates)
+{
+    std::ostringstream operation;
+
+    operation << "Notify " << INVENTORY_MANAGER_OBJECT << path;
+    for (const auto& [interface, properties] : updates)
+    {
+        operation << "\n    " << interface;
+        for (const auto& [property, value] : properties)
+        {
+            operation << "\n        " << property << " = ";
+            formatProperty(operation, value);
+        }
+    }
+
+    record(operation.str());
+}
+
+void RecordingInventory::add(const std::string& path,
+                             const interfaces::Interface& iface)
+{
+    ObjectType updates;
+
+    iface.populateObject(updates);
+
+    updateObject(path, updates);
+}
+
+void RecordingInventory::remove(const std::string& path,
+                                const interfaces::Interface& iface)
+{
+    ObjectType updates;
+
+    iface.depopulateObject(updates);
+
+    updateObject(path, updates);
+}
+
+void RecordingInventory::markPresent(const std::string& path)
+{
+    record("Set " + std::string(INVENTORY_MANAGER_OBJECT) + path + " " +
+           INVENTORY_ITEM_IFACE + " Present true");
+
+    std::lock_guard guard(lock);
+    presentCache[path] = true;
+}
+
+void RecordingInventory::markAbsent(const std::string& path)
+{
+    record("Set " + std::string(INVENTORY_MANAGER_OBJECT) + path + " " +
+           INVENTORY_ITEM_IFACE + " Present false");
+
+    std::lock_guard guard(lock);
+    presentCache[path] = false;
+}
+
+bool RecordingInventory::isPresent(const std::string& path)
+{
+    record("Get " + std::string(INVENTORY_MANAGER_OBJECT) + path + " " +
+           INVENTORY_ITEM_IFACE + " Present");
+
+    std::lock_guard guard(lock);
+    auto found = presentCache.find(path);
+
+    return found != presentCache.end() && found->second;
+}
+
+bool RecordingInventory::isModel(const std::string& path,
+                                 [[maybe_unused]] const std::string& model)
+{
+    record("Get " + std::string(INVENTORY_MANAGER_OBJECT) + path + " " +
+           INVENTORY_DECORATOR_ASSET_IFACE + " Model");
+
+    /* Nothing publishes the asset decorator for us to match against */
+    return false;
+}
@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "inventory.hpp"
+
+#include <utility>
+
+using namespace inventory;
+using namespace dbus;
+
+SynchronisedInventoryDecorator::SynchronisedInventoryDecorator(
+    Inventory* inventory) : inventory(inventory), held(false)
+{}
+
+std::unique_lock<std::mutex> SynchronisedInventoryDecorator::acquire()
+{
+    std::unique_lock guard(lock);
+    released.wait(guard, [this]() { return !held; });
+    return guard;
+}
+
+void SynchronisedInventoryDecorator::hold()
+{
+    std::lock_guard guard(lock);
+    held = true;
+}
+
+void SynchronisedInventoryDecorator::migrate(
+    std::span<Migration*>&& migrations)
+{
+    /* Migrations run ahead of the operations that are held */
+    std::lock_guard guard(lock);
+
+    try
+    {
+        inventory->migrate(std::forward<std::span<Migration*>>(migrations));
+    }
+    catch (...)
+    {
+        held = false;
+        released.notify_all();
+        throw;
+    }
+
+    held = false;
+    released.notify_all();
+}
+
+std::weak_ptr<PropertiesChangedListener>
+    SynchronisedInventoryDecorator::addPropertiesChangedListener(
+        const std::string& path, const std::string& interface,
+        std::function<void(PropertiesChanged&&)> callback)
+{
+    std::unique_lock guard = acquire();
+    return inventory->addPropertiesChangedListener(path, interface, callback);
+}
+
+void SynchronisedInventoryDecorator::removePropertiesChangedListener(
+    std::weak_ptr<PropertiesChangedListener> listener)
+{
+    std::unique_lock guard = acquire();
+    inventory->removePropertiesChangedListener(listener);
+}
+
+void SynchronisedInventoryDecorator::add(const std::string& path,
+                                         const interfaces::Interface& iface)
+{
+    std::unique_lock guard = acquire();
+    inventory->add(path, iface);
+}
+
+void SynchronisedInventoryDecorator::remove(const std::string& path,
+                                            const interfaces::Interface& iface)
+{
+    std::unique_lock guard = acquire();
+    inventory->remove(path, iface);
+}
+
+void SynchronisedInventoryDecorator::markPresent(const std::string& path)
+{
+    std::unique_lock guard = acquire();
+    inventory->markPresent(path);
+}
+
+void SynchronisedInventoryDecorator::markAbsent(const std::string& path)
+{
+    std::unique_lock guard = acquire();
+    inventory->markAbsent(path);
+}
+
+bool SynchronisedInventoryDecorator::isPresent(const std::string& path)
+{
+    std::unique_lock guard = acquire();
+    return inventory->isPresent(path);
+}
+
+bool SynchronisedInventoryDecorator::isModel(const std::string& path,
+                                             const std::string& model)
+{
+    std::unique_lock guard = acquire();
+    return inventory->isModel(path, model);
+}
@@ -7,9 +7,13 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+#include <bit>
 #include <cerrno>
 #include <csignal>
 #include <cstring>
+#include <string>
+#include <utility>
 #include <system_error>
 
 extern "C"
@@ -40,6 +44,8 @@ Notifier::Notifier()
     ::sigemptyset(&mask);
     ::sigaddset(&mask, SIGINT);
     ::sigaddset(&mask, SIGQUIT);
+    ::sigaddset(&mask, SIGTERM);
+    ::sigaddset(&mask, SIGHUP);
     int rc = ::sigprocmask(SIG_BLOCK, &mask, nullptr);
     if (rc == -1)
     {
@@ -98,6 +104,11 @@ void Notifier::add(NotifySink* sink)
         throw std::system_category().default_error_condition(errno);
     }
 
+    {
+        std::scoped_lock guard(sinksLock);
+        sinks.push_back(sink);
+    }
+
     debug("Added event descriptor {EVENT_FD} to epoll ({EPOLL_FD})", "EVENT_FD",
           sink->getFD(), "EPOLL_FD", epollfd);
 }
@@ -124,14 +135,277 @@ void Notifier::remove(NotifySink* sink)
     debug("Removed event descriptor {EVENT_FD} from epoll ({EPOLL_FD})",
           "EVENT_FD", sink->getFD(), "EPOLL_FD", epollfd);
 
+    {
+        std::scoped_lock guard(sinksLock);
+        std::erase(sinks, sink);
+    }
+
     sink->disarm();
 }
 
+void Notifier::rescan()
+{
+    std::scoped_lock guard(sinksLock);
+
+    debug("Rescanning {SINK_COUNT} event sinks", "SINK_COUNT", sinks.size());
+
+    for (NotifySink* sink : sinks)
+    {
+        sink->rescan();
+    }
+}
+
+int Notifier::getExitSignal() const
+{
+    return exitSignal;
+}
+
+void Notifier::setOneShot(bool oneShot)
+{
+    this->oneShot = oneShot;
+}
+
+bool Notifier::isOneShot() const
+{
+    return oneShot;
+}
+
+void Notifier::addPresenceListener(PresenceListener* listener)
+{
+    std::lock_guard guard(presenceLock);
+    presenceListeners.push_back(listener);
+}
+
+void Notifier::removePresenceListener(PresenceListener* listener)
+{
+    std::lock_guard guard(presenceLock);
+    std::erase(presenceListeners, listener);
+}
+
+void Notifier::presenceChanged(ConnectorID id, bool present)
+{
+    if (id == presence::unassigned)
+    {
+        return;
+    }
+
+    PresenceEvent event{id, false, present, std::chrono::steady_clock::now()};
+    bool queue = false;
+
+    {
+        std::lock_guard guard(presenceLock);
+        bool transition = true;
+
+        if (id < presence::tableCapacity)
+        {
+            restoredAbsentConnectors.reset(id);
+            restoredPresentConnectors.reset(id);
+
+            event.previous = presentConnectors.test(id);
+            if (present)
+            {
+                presentConnectors.set(id);
+            }
+            else
+            {
+                presentConnectors.reset(id);
+            }
+
+            /*
+             * Re-publishing the current state isn't a transition. Connectors
+             * start out absent, so neither is cold-plug of an empty slot.
+             */
+            transition = event.previous != present;
+        }
+
+        for (auto* listener : presenceListeners)
+        {
+            listener->presenceChanged(id, present);
+        }
+
+        queue = transition && !presenceSubscribers.empty();
+    }
+
+    if (queue)
+    {
+        queuePresenceEvent(event);
+    }
+}
+
+void Notifier::presenceFlapped(ConnectorID id, uint32_t flaps)
+{
+    if (id == presence::unassigned)
+    {
+        return;
+    }
+
+    if (flaps >= flapWarningThreshold && std::has_single_bit(flaps))
+    {
+        warning(
+            "Presence of connector {CONNECTOR_ID} has flapped {FLAP_COUNT} times, check its seating",
+            "CONNECTOR_ID", id, "FLAP_COUNT", flaps);
+    }
+
+    std::lock_guard guard(presenceLock);
+    for (auto* listener : presenceListeners)
+    {
+        listener->presenceFlapped(id);
+    }
+}
+
+void Notifier::presenceIdentified(ConnectorID id, uint32_t fingerprint)
+{
+    if (id == presence::unassigned)
+    {
+        return;
+    }
+
+    std::lock_guard guard(presenceLock);
+    for (auto* listener : presenceListeners)
+    {
+        listener->presenceIdentified(id, fingerprint);
+    }
+}
+
+void Notifier::queuePresenceEvent(const PresenceEvent& event)
+{
+    for (;;)
+    {
+        {
+            std::lock_guard guard(presenceLock);
+            if (queuedCount < queuedEvents.size())
+            {
+                queuedEvents.at(queuedCount++) = event;
+                return;
+            }
+        }
+
+        /* The batch is full, deliver it to make room */
+        flushPresenceEvents();
+    }
+}
+
+void Notifier::addPresenceSubscriber(PresenceSubscriber* subscriber)
+{
+    std::lock_guard dispatch(dispatchLock);
+    std::lock_guard guard(presenceLock);
+    presenceSubscribers.push_back(subscriber);
+}
+
+void Notifier::removePresenceSubscriber(PresenceSubscriber* subscriber)
+{
+    std::lock_guard dispatch(dispatchLock);
+    std::lock_guard guard(presenceLock);
+    std::erase(presenceSubscribers, subscriber);
+}
+
+void Notifier::flushPresenceEvents()
+{
+    std::lock_guard dispatch(dispatchLock);
+    std::size_t count = 0;
+
+    {
+        std::lock_guard guard(presenceLock);
+        count = queuedCount;
+        std::copy_n(queuedEvents.begin(), count, deliveredEvents.begin());
+        queuedCount = 0;
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    std::span<const PresenceEvent> batch(deliveredEvents.data(), count);
+    for (auto* subscriber : presenceSubscribers)
+    {
+        subscriber->presenceEvents(batch);
+    }
+}
+
+void Notifier::restoreAbsent(
+    const PresenceBitmap<presence::tableCapacity>& absent)
+{
+    std::lock_guard guard(presenceLock);
+    restoredAbsentConnectors = absent;
+
+    debug("Restored {CONNECTOR_COUNT} absent connectors", "CONNECTOR_COUNT",
+          absent.count());
+}
+
+bool Notifier::consumeRestoredAbsent(ConnectorID id)
+{
+    if (id >= presence::tableCapacity)
+    {
+        return false;
+    }
+
+    std::lock_guard guard(presenceLock);
+    bool absent = restoredAbsentConnectors.test(id);
+    restoredAbsentConnectors.reset(id);
+
+    return absent;
+}
+
+void Notifier::restorePresent(
+    const PresenceBitmap<presence::tableCapacity>& present,
+    const presence::Fingerprints& fingerprints)
+{
+    std::lock_guard guard(presenceLock);
+    restoredPresentConnectors = present;
+    restoredFingerprints = fingerprints;
+
+    debug("Restored {CONNECTOR_COUNT} present connectors", "CONNECTOR_COUNT",
+          present.count());
+}
+
+std::optional<uint32_t> Notifier::consumeRestoredPresent(ConnectorID id)
+{
+    if (id >= presence::tableCapacity)
+    {
+        return std::nullopt;
+    }
+
+    std::lock_guard guard(presenceLock);
+    if (!restoredPresentConnectors.test(id))
+    {
+        return std::nullopt;
+    }
+    restoredPresentConnectors.reset(id);
+
+    return restoredFingerprints.at(id);
+}
+
+void Notifier::setStartupReport(StartupReport* report)
+{
+    startup = report;
+}
+
+StartupReport::Phase Notifier::startupPhase(std::string&& name)
+{
+    return {startup, std::move(name)};
+}
+
 void Notifier::run()
 {
     struct epoll_event event{};
     int rc = 0;
 
+    /* Deliver the transitions published by cold-plug */
+    flushPresenceEvents();
+
+    /* Cold-plug is complete by the time we wait on hot-plug events */
+    if (startup != nullptr)
+    {
+        startup->ready();
+    }
+
+    if (oneShot)
+    {
+        info("Cold-plug complete, skipping notify event loop");
+        return;
+    }
+
     for (;;)
     {
         rc = ::epoll_wait(epollfd, &event, 1, -1);
@@ -166,7 +440,15 @@ void Notifier::run()
                 throw std::system_category().default_error_condition(EBADMSG);
             }
 
-            if (fdsi.ssi_signo != SIGINT && fdsi.ssi_signo != SIGQUIT)
+            if (fdsi.ssi_signo == SIGHUP)
+            {
+                info("Rescanning connectors on request");
+                rescan();
+                continue;
+            }
+
+            if (fdsi.ssi_signo != SIGINT && fdsi.ssi_signo != SIGQUIT &&
+                fdsi.ssi_signo != SIGTERM)
             {
                 error("signalfd provided unexpected signal: {SIGNAL}", "SIGNAL",
                       fdsi.ssi_signo);
@@ -174,6 +456,7 @@ void Notifier::run()
             }
 
             /* Time to clean up */
+            exitSignal = static_cast<int>(fdsi.ssi_signo);
             break;
         }
 
@@ -196,6 +479,9 @@ void Notifier::run()
                 "ERROR", err.value());
             remove(sink);
         }
+
+        /* Deliver the transitions published by this dispatch iteration */
+        flushPresenceEvents();
     }
 
     info("Exiting notify event loop");
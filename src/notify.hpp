@@ -2,9 +2,17 @@
 /* Copyright IBM Corp. 2021 */
 #pragma once
 
+#include "presence.hpp"
+#include "startup.hpp"
+
+#include <array>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 class NotifySink;
 
@@ -23,9 +31,95 @@ class Notifier
     void remove(NotifySink* sink);
     void run();
 
+    /*
+     * Ask the sinks to sample as soon as possible, e.g. after the host powers
+     * on. run() also rescans on SIGHUP.
+     */
+    void rescan();
+
+    /* The signal that terminated run(), or 0 */
+    int getExitSignal() const;
+
+    /* Return from run() once cold-plug is complete, e.g. for --once */
+    void setOneShot(bool oneShot);
+    bool isOneShot() const;
+
+    void addPresenceListener(PresenceListener* listener);
+    void removePresenceListener(PresenceListener* listener);
+    void presenceChanged(ConnectorID id, bool present);
+
+    /*
+     * Forwarded to the presence listeners. flaps is the connector's count
+     * since its poller started, and a warning is logged each time it doubles
+     * from flapWarningThreshold so a noisy connector can't flood the journal.
+     */
+    static constexpr uint32_t flapWarningThreshold = 8;
+    void presenceFlapped(ConnectorID id, uint32_t flaps);
+    void presenceIdentified(ConnectorID id, uint32_t fingerprint);
+
+    /*
+     * The presence event bus. Transitions are queued as they're published and
+     * delivered to subscribers in a batch at the end of each dispatch
+     * iteration of run(), when run() starts, or when the queue fills.
+     * Subscribers must not publish presence from their callbacks.
+     */
+    void addPresenceSubscriber(PresenceSubscriber* subscriber);
+    void removePresenceSubscriber(PresenceSubscriber* subscriber);
+    void flushPresenceEvents();
+
+    /*
+     * Connectors that are known to be unplugged from the inventory, e.g. by a
+     * previous instance of the daemon. The knowledge is consumed by the first
+     * query for the connector or the first transition it publishes.
+     */
+    void restoreAbsent(const PresenceBitmap<presence::tableCapacity>& absent);
+    bool consumeRestoredAbsent(ConnectorID id);
+
+    /*
+     * Likewise, connectors known to be plugged into the inventory, with the
+     * fingerprints of their FRUs. Their devices are adopted, see
+     * Device::adopt().
+     */
+    void restorePresent(const PresenceBitmap<presence::tableCapacity>& present,
+                        const presence::Fingerprints& fingerprints);
+    std::optional<uint32_t> consumeRestoredPresent(ConnectorID id);
+
+    /*
+     * Phases of cold-plug are timed against the startup report, if any, and
+     * run() reports readiness before it starts waiting on events.
+     */
+    void setStartupReport(StartupReport* report);
+    StartupReport::Phase startupPhase(std::string&& name);
+
   private:
+    void queuePresenceEvent(const PresenceEvent& event);
+
     int epollfd;
     int exitfd;
+    /* Sinks may be added from a WorkPool during cold-plug */
+    std::mutex sinksLock;
+    std::vector<NotifySink*> sinks;
+    int exitSignal = 0;
+    bool oneShot = false;
+    /* Transitions may be published from a WorkPool during cold-plug */
+    std::mutex presenceLock;
+    std::vector<PresenceListener*> presenceListeners;
+    PresenceBitmap<presence::tableCapacity> restoredAbsentConnectors;
+    PresenceBitmap<presence::tableCapacity> restoredPresentConnectors;
+    presence::Fingerprints restoredFingerprints{};
+
+    static constexpr std::size_t eventBatchCapacity = presence::tableCapacity;
+
+    /* Serialises delivery of batches to the subscribers */
+    std::mutex dispatchLock;
+    std::vector<PresenceSubscriber*> presenceSubscribers;
+    /* Protected by presenceLock */
+    PresenceBitmap<presence::tableCapacity> presentConnectors;
+    std::array<PresenceEvent, eventBatchCapacity> queuedEvents{};
+    std::size_t queuedCount = 0;
+    /* Protected by dispatchLock */
+    std::array<PresenceEvent, eventBatchCapacity> deliveredEvents{};
+    StartupReport* startup = nullptr;
 };
 
 class NotifySink
@@ -37,4 +131,7 @@ class NotifySink
     virtual void notify(Notifier& notifier) = 0;
 
     virtual void disarm() {}
+
+    /* Sample again as soon as possible, if the sink polls */
+    virtual void rescan() {}
 };
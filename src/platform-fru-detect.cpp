@@ -4,42 +4,141 @@
 #include "environment.hpp"
 #include "inventory.hpp"
 #include "platform.hpp"
+#include "platforms.h"
+#include "polling.hpp"
+#include "power.hpp"
+#include "presence.hpp"
+#include "startup.hpp"
+#include "sysfs/i2c.hpp"
+#include "sysfs/sysfs.hpp"
+#include "tasks.hpp"
+#include "uevent.hpp"
+
+#if PLATFORM_BONNELL
 #include "platforms/bonnell.hpp"
+#endif
+#if PLATFORM_EVEREST
 #include "platforms/everest.hpp"
+#endif
+#if PLATFORM_RAINIER
 #include "platforms/rainier.hpp"
+#endif
+
+#include <getopt.h>
 
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/bus.hpp>
 
 #include <array>
+#include <cerrno>
 #include <chrono>
 #include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <optional>
 #include <variant>
 #include <vector>
 
 PHOSPHOR_LOG2_USING;
 
-int main()
+static void usage(const char* name, std::ostream& out)
 {
+    out << "Usage: " << name << " [OPTION]...\n"
+        << "\n"
+        << "  --once              Exit with a summary after cold-plug\n"
+        << "  --dry-run           Print inventory operations, don't make them\n"
+        << "  --root PATH         Find /sys and /dev beneath PATH, not /\n"
+        << "  --poll-config PATH  Read poll policies from PATH\n"
+        << "  --help              Show this message\n";
+}
+
+int main(int argc, char* argv[])
+{
+    static const std::array<struct option, 6> options = {{
+        {"once", no_argument, nullptr, 'o'},
+        {"dry-run", no_argument, nullptr, 'n'},
+        {"root", required_argument, nullptr, 'r'},
+        {"poll-config", required_argument, nullptr, 'p'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    }};
+
+    bool once = false;
+    bool dryRun = false;
+    std::filesystem::path pollConfig = PollPolicies::defaultPath;
+    int opt = 0;
+
+    while ((opt = ::getopt_long(argc, argv, "onr:p:h", options.data(),
+                                nullptr)) != -1)
+    {
+        switch (opt)
+        {
+            case 'o':
+                once = true;
+                break;
+            case 'n':
+                dryRun = true;
+                break;
+            case 'r':
+                sysfs::setRoot(optarg);
+                break;
+            case 'p':
+                pollConfig = optarg;
+                break;
+            case 'h':
+                usage(program_invocation_short_name, std::cout);
+                return EXIT_SUCCESS;
+            default:
+                usage(program_invocation_short_name, std::cerr);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind < argc)
+    {
+        usage(program_invocation_short_name, std::cerr);
+        return EXIT_FAILURE;
+    }
+
+    /* Only the long-running daemon claims the once-per-boot timing report */
+    std::filesystem::path marker;
+    if (!once && !dryRun)
+    {
+        marker = StartupReport::defaultMarkerPath;
+    }
+    StartupReport startup(marker);
+
+    PollPolicies::instance().load(pollConfig);
+
+    StartupReport::Phase modelPhase = startup.phase("Reading platform model");
     PlatformManager pm;
 
+    /* Only the platforms selected at build time are compiled in */
+#if PLATFORM_BONNELL
     Bonnell bonnell;
     bonnell.enrollWith(pm);
+#endif
 
+#if PLATFORM_EVEREST
     Everest everest;
     everest.enrollWith(pm);
+#endif
 
+#if PLATFORM_RAINIER
     Rainier0z rainier0z;
     rainier0z.enrollWith(pm);
 
     Rainier1z rainier1z;
     rainier1z.enrollWith(pm);
+#endif
+
+    modelPhase.end();
 
     if (!pm.isSupportedPlatform())
     {
         warning("Unsupported platform: '{PLATFORM_MODEL}'", "PLATFORM_MODEL",
                 pm.getPlatformModel());
+        startup.finish("Unsupported platform");
         return 0;
     }
 
@@ -54,16 +153,132 @@ int main()
     SimicsExecutionEnvironment simics;
     em.enrollEnvironment(&simics);
 
-    sdbusplus::bus::bus dbus = sdbusplus::bus::new_default();
     Notifier notifier;
-    InventoryManager inventory(dbus);
+    notifier.setStartupReport(&startup);
+    notifier.setOneShot(once);
+
+    /* A dry-run neither connects to D-Bus nor touches the runtime state */
+    std::optional<sdbusplus::bus::bus> dbus;
+    std::optional<InventoryManager> manager;
+    std::optional<DBusNotifySink> dbusSink;
+    std::optional<HostPowerMonitor> hostPower;
+    std::optional<RecordingInventory> recording;
+    Inventory* inventory = nullptr;
 
-    DBusNotifySink dbusSink(dbus);
-    notifier.add(&dbusSink);
+    {
+        /*
+         * Index the I2C topology on the pool while we connect to D-Bus and
+         * prefetch the inventory objects the migrations consume, as neither
+         * depends on the other
+         */
+        WorkPool pool(1);
+        TaskGroup group;
+
+        group.spawn([&startup]() {
+            StartupReport::Phase phase = startup.phase("Indexing I2C topology");
+            SysfsI2CTopology::instance().scan();
+        });
+
+        if (dryRun)
+        {
+            recording.emplace(std::cout);
+            inventory = &recording.value();
+        }
+        else
+        {
+            StartupReport::Phase phase = startup.phase("Connecting to D-Bus");
 
-    em.run(pm, notifier, &inventory);
+            dbus.emplace(sdbusplus::bus::new_default());
+            manager.emplace(dbus.value());
+            manager->prefetch();
+            inventory = &manager.value();
 
-    notifier.remove(&dbusSink);
+            dbusSink.emplace(dbus.value());
+            notifier.add(&dbusSink.value());
+
+            /* Suspend endpoint probes while the host is off */
+            hostPower.emplace(dbus.value(), notifier);
+        }
+
+        group.wait();
+    }
+
+    /* Track driver binds and device changes rather than racing sysfs */
+    std::optional<UeventMonitor> ueventMonitor;
+    try
+    {
+        ueventMonitor.emplace();
+        notifier.add(&ueventMonitor.value());
+        SysfsI2CBus::setDriverBindWaiter(&ueventMonitor.value());
+    }
+    catch (const std::error_condition& err)
+    {
+        warning("Failed to monitor uevents, continuing without them");
+        ueventMonitor.reset();
+    }
+
+    std::optional<PresenceTable> presenceTable;
+    if (!dryRun)
+    {
+        try
+        {
+            presenceTable.emplace(PresenceTable::defaultPath);
+            notifier.addPresenceListener(&presenceTable.value());
+            /*
+             * Skip cleaning up inventory that's clean after a restart, and
+             * adopt what the previous instance left present
+             */
+            notifier.restoreAbsent(presenceTable->restoredAbsent());
+            notifier.restorePresent(presenceTable->restoredPresent(),
+                                    presenceTable->restoredFingerprints());
+        }
+        catch (const std::error_condition& err)
+        {
+            warning("Failed to create presence table, continuing without it");
+        }
+    }
+
+    PresenceTally tally;
+    notifier.addPresenceListener(&tally);
+
+    em.run(pm, notifier, inventory);
+
+    /* The Simics environment returns early from failed cold-plugs */
+    startup.finish("Exited");
+
+    notifier.removePresenceListener(&tally);
+
+    if (presenceTable)
+    {
+        notifier.removePresenceListener(&presenceTable.value());
+    }
+
+    if (ueventMonitor)
+    {
+        SysfsI2CBus::setDriverBindWaiter(nullptr);
+        notifier.remove(&ueventMonitor.value());
+    }
+
+    if (dbusSink)
+    {
+        notifier.remove(&dbusSink.value());
+    }
+
+    if (once)
+    {
+        std::cout << "Detected " << tally.count() << " present connectors on '"
+                  << pm.getPlatformModel() << "' in "
+                  << startup.getElapsed().count() << "us\n";
+        for (const auto& [name, duration] : startup.getPhases())
+        {
+            std::cout << "    " << name << ": " << duration.count() << "us\n";
+        }
+        if (recording)
+        {
+            std::cout << "Recorded " << recording->getOperationCount()
+                      << " inventory operations\n";
+        }
+    }
 
     return 0;
 }
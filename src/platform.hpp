@@ -2,20 +2,30 @@
 /* Copyright IBM Corp. 2021 */
 #pragma once
 
+#include "inline-function.hpp"
 #include "notify.hpp"
+#include "polling.hpp"
+#include "presence.hpp"
 #include "sysfs/i2c.hpp"
+#include "tasks.hpp"
 
 #include <gpiod.hpp>
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cassert>
 #include <cerrno>
+#include <concepts>
+#include <csignal>
 #include <cstring>
-#include <functional>
+#include <limits>
 #include <map>
 #include <optional>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 extern "C"
 {
@@ -31,26 +41,72 @@ class Device
     {
         UNPLUG_RETAINS_INVENTORY = 1,
         UNPLUG_REMOVES_INVENTORY,
+        /* Also leave kernel devices bound for the next instance to adopt */
+        UNPLUG_RETAINS_DEVICES,
     };
 
     virtual void plug(Notifier& notifier) = 0;
     virtual void unplug(Notifier& notifier,
                         int mode = UNPLUG_REMOVES_INVENTORY) = 0;
+
+    /*
+     * Restarts within a boot. The fingerprint identifies the FRU beyond its
+     * presence, e.g. a drive's serial, and is 0 if presence is all there is.
+     * It's persisted in the presence table so the next instance of the daemon
+     * can adopt() the device in place of plug(), trusting the kernel devices
+     * and the inventory the previous instance left behind. The first poll
+     * after adoption calls verify() so the device can check its FRU is the
+     * one it was adopted with, and re-publish it if not.
+     */
+    virtual uint32_t getFingerprint() const
+    {
+        return 0;
+    }
+
+    virtual void adopt(Notifier& notifier,
+                       [[maybe_unused]] uint32_t fingerprint)
+    {
+        plug(notifier);
+    }
+
+    virtual void verify([[maybe_unused]] Notifier& notifier) {}
 };
 
+/*
+ * Planned restarts, e.g. by systemd, stop the daemon with SIGTERM. Leave the
+ * kernel devices in place across them so the next instance doesn't have to
+ * re-create the devices and wait for the drivers to bind. A one-shot pass
+ * leaves them in place for whatever runs after it.
+ */
+inline int unplugModeForExit(const Notifier& notifier)
+{
+    if (notifier.isOneShot() || notifier.getExitSignal() == SIGTERM)
+    {
+        return Device::UNPLUG_RETAINS_DEVICES;
+    }
+
+    return Device::UNPLUG_RETAINS_INVENTORY;
+}
+
 template <typename T>
 concept DerivesDevice = std::is_base_of<Device, T>::value;
 
+/*
+ * The device is constructed in place in the connector from the retained
+ * constructor arguments, so populating and depopulating a connector doesn't
+ * touch the heap beyond what the device itself does in plug() and unplug().
+ */
 template <DerivesDevice T>
 class Connector
 {
   public:
+    /* Enough for the connector and the device constructor arguments */
+    static constexpr std::size_t ctorCapacity = 8 * sizeof(void*);
+
     template <typename... DeviceArgs>
     explicit Connector(int idx, DeviceArgs&&... args) :
-        state(CONNECTOR_UNINITIALISED), idx(idx), device(),
-        ctor([this, args...]() mutable {
-            device.emplace(std::forward<DeviceArgs>(args)...);
-        })
+        state(CONNECTOR_UNINITIALISED), idx(idx), id(presence::unassigned),
+        device(), ctor([this, args...]() { device.emplace(args...); })
     {}
     Connector(const Connector<T>& other) = delete;
     Connector(Connector<T>&& other) = delete;
@@ -64,17 +120,73 @@ class Connector
         switch (state)
         {
             case CONNECTOR_UNINITIALISED:
+                // A previous instance of the daemon plugged the device during
+                // this boot, so the inventory and the kernel devices are
+                // already in place.
+                if (std::optional<uint32_t> fingerprint =
+                        notifier.consumeRestoredPresent(id))
+                {
+                    lg2::debug("Adopting connector");
+                    ctor();
+                    device->adopt(notifier, *fingerprint);
+                    state = CONNECTOR_POPULATED;
+                    adopted = true;
+                    notifier.presenceChanged(id, true);
+                    return;
+                }
+                [[fallthrough]];
             case CONNECTOR_DEPOPULATED:
                 lg2::debug("Populating connector");
                 ctor();
                 device->plug(notifier);
                 state = CONNECTOR_POPULATED;
+                notifier.presenceChanged(id, true);
+                notifier.presenceIdentified(id, device->getFingerprint());
                 return;
             case CONNECTOR_POPULATED:
                 return;
         }
     }
 
+    bool isAdopted() const
+    {
+        return adopted;
+    }
+
+    /*
+     * Verify an adopted device, once presence has been polled. Failures are
+     * retried on the next poll.
+     */
+    void verify(Notifier& notifier)
+    {
+        if (!adopted)
+        {
+            return;
+        }
+
+        try
+        {
+            device->verify(notifier);
+            adopted = false;
+            notifier.presenceIdentified(id, device->getFingerprint());
+        }
+        catch (const std::exception& ex)
+        {
+            lg2::debug("Failed to verify adopted connector: {EXCEPTION}",
+                       "EXCEPTION", ex);
+        }
+        catch (const std::error_condition& err)
+        {
+            lg2::debug("Failed to verify adopted connector: {ERROR}", "ERROR",
+                       err.value());
+        }
+    }
+
+    /*
+     * Absence is only published if the inventory is updated to match, so the
+     * presence table continues to reflect the hardware when the inventory is
+     * retained across a restart of the daemon.
+     */
     void depopulate(Notifier& notifier, int mode = T::UNPLUG_REMOVES_INVENTORY)
     {
         switch (state)
@@ -82,6 +194,13 @@ class Connector
             case CONNECTOR_DEPOPULATED:
                 return;
             case CONNECTOR_UNINITIALISED:
+                // A previous instance of the daemon unplugged the device during
+                // this boot, so the inventory already reflects its absence.
+                if (notifier.consumeRestoredAbsent(id))
+                {
+                    state = CONNECTOR_DEPOPULATED;
+                    return;
+                }
                 // Construct the device so we can explicitly unplug() it. This
                 // is used to e.g. remove the device from the inventory when it
                 // has been removed from the system while AC power is unplugged.
@@ -92,6 +211,11 @@ class Connector
                 device->unplug(notifier, mode);
                 device.reset();
                 state = CONNECTOR_DEPOPULATED;
+                adopted = false;
+                if (mode == T::UNPLUG_REMOVES_INVENTORY)
+                {
+                    notifier.presenceChanged(id, false);
+                }
                 return;
         }
     }
@@ -101,6 +225,18 @@ class Connector
         return idx;
     }
 
+    /* Report a presence change that cleared before it was applied */
+    void flapped(Notifier& notifier, uint32_t flaps) const
+    {
+        notifier.presenceFlapped(id, flaps);
+    }
+
+    /* Publish transitions against the stable ID for the connector */
+    void identify(ConnectorID connectorID)
+    {
+        id = connectorID;
+    }
+
   private:
     enum ConnectorState
     {
@@ -110,45 +246,84 @@ class Connector
     };
 
     ConnectorState state;
+    bool adopted = false;
     const int idx;
+    ConnectorID id;
     std::optional<T> device;
-    std::function<void(void)> ctor;
+    InlineFunction<void(), ctorCapacity> ctor;
 };
 
+/*
+ * Inventory paths are computed once as the topology is built and remain valid
+ * for the lifetime of the FRU, so they're cheap to pass through the inventory
+ * on each plug and unplug.
+ */
 class FRU
 {
   public:
-    virtual std::string getInventoryPath() const = 0;
+    virtual const std::string& getInventoryPath() const = 0;
     virtual void addToInventory(Inventory* inventory) = 0;
     virtual void removeFromInventory(Inventory* inventory) = 0;
 };
 
 /*
- * TODO: Add multiple instances to a single timerfd to make it more efficient
+ * Presence probes are stored by value in the poller and invoked on each tick,
+ * so they're statically dispatched and may carry state between samples.
+ */
+template <typename P>
+concept PresenceProbe =
+    std::move_constructible<P> && std::is_invocable_r_v<bool, P&>;
+
+/*
+ * Probes that issue I2C transactions report the bus they address, the
+ * physical adapter carrying it, and whether their next sample will touch the
+ * bus at all. Arrays use this to order and budget their samples.
+ */
+template <typename P>
+concept BusProbe = PresenceProbe<P> && requires(const P& probe) {
+    { probe.getBus() } -> std::convertible_to<int>;
+    { probe.getAdapter() } -> std::convertible_to<int>;
+    { probe.usesBus() } -> std::convertible_to<bool>;
+};
+
+/* Reports presence as the value of an active-low GPIO line */
+class GpioLinePresence
+{
+  public:
+    GpioLinePresence() = delete;
+    explicit GpioLinePresence(gpiod::line&& line) : line(std::move(line)) {}
+
+    bool operator()() const
+    {
+        return line.get_value() != 0;
+    }
+
+  private:
+    gpiod::line line;
+};
+
+/*
+ * The timer driving presence polling. Each expiry is scheduled individually:
+ * the interval of the class's PollPolicy is used while presence is changing,
+ * and it doubles towards the policy's latency while presence is stable.
  *
- * Haven't done this yet as I already have enough to think about to get it all
- * to work.
+ * The first expiry after arming is offset by a phase the ProbeScheduler
+ * assigns, so timers on the same adapter don't fire together. A rescan expires
+ * immediately.
  */
-template <DerivesDevice T>
-class PolledDevicePresence : public NotifySink
+class PollTimer
 {
   public:
-    PolledDevicePresence() = delete;
-    PolledDevicePresence(Connector<T>* connector,
-                         const std::function<bool()>& poll) :
-        connector(connector), poll(poll), timerfd(-1)
-    {}
-    PolledDevicePresence(const PolledDevicePresence<T>& other) = default;
-    PolledDevicePresence(PolledDevicePresence<T>&& other) noexcept = default;
-    virtual ~PolledDevicePresence() = default;
+    PollTimer() = default;
+    explicit PollTimer(const char* pollClass) : pollClass(pollClass) {}
+    PollTimer(const PollTimer& other) = default;
+    PollTimer(PollTimer&& other) noexcept = default;
+    ~PollTimer() = default;
 
-    PolledDevicePresence<T>&
-        operator=(const PolledDevicePresence<T>& other) = default;
-    PolledDevicePresence<T>&
-        operator=(PolledDevicePresence<T>&& other) noexcept = default;
+    PollTimer& operator=(const PollTimer& other) = default;
+    PollTimer& operator=(PollTimer&& other) noexcept = default;
 
-    /* NotifySink */
-    void arm() override
+    void arm(int adapter = ProbeScheduler::noAdapter)
     {
         assert(timerfd == -1 && "Bad state: timer already armed");
 
@@ -159,56 +334,48 @@ class PolledDevicePresence : public NotifySink
                        "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO", errno);
         }
 
-        struct itimerspec interval{{1, 0}, {1, 0}};
+        policy = PollPolicies::instance().get(pollClass);
+        this->adapter = adapter;
+        phase = ProbeScheduler::instance().assignPhase(adapter);
+        current = policy.interval;
+        expireAfter(current * phase);
+    }
 
-        int rc = ::timerfd_settime(timerfd, 0, &interval, nullptr);
-        if (rc == -1)
+    /* Schedule the next expiry, tightening the interval if presence changed */
+    void schedule(bool changed)
+    {
+        if (timerfd == -1)
         {
-            close(timerfd);
-
-            lg2::error(
-                "Failed to set interval for timerfd: {ERRNO_DESCRIPTION}",
-                "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO", errno);
+            return;
         }
-    }
 
-    int getFD() override
-    {
-        return timerfd;
+        current = changed ? policy.interval
+                          : std::min(current * 2, policy.latency);
+        expireAfter(current);
     }
 
-    void notify(Notifier& notifier) override
+    /* Expire now and return to the policy's interval */
+    void rescan()
     {
-        drain();
-
-        if (poll())
-        {
-            try
-            {
-                connector->populate(notifier);
-            }
-            catch (const SysfsI2CDeviceDriverBindException& ex)
-            {
-                lg2::error(
-                    "Failed to bind driver for device reporting present, disabling notifier: {EXCEPTION}",
-                    "EXCEPTION", ex);
-                notifier.remove(this);
-            }
-        }
-        else
+        if (timerfd == -1)
         {
-            connector->depopulate(notifier);
+            return;
         }
+
+        current = policy.interval;
+        expireAfter(std::chrono::nanoseconds(1));
     }
 
-    void disarm() override
+    std::chrono::milliseconds getInterval() const
     {
-        assert(timer > -1 && "Bad state: Timer already disarmed");
-        ::close(timerfd);
-        timerfd = -1;
+        return current;
+    }
+
+    int getFD() const
+    {
+        return timerfd;
     }
 
-  private:
     uint64_t drain()
     {
         uint64_t res = 0;
@@ -234,12 +401,136 @@ class PolledDevicePresence : public NotifySink
         return res;
     }
 
+    void disarm()
+    {
+        assert(timerfd > -1 && "Bad state: Timer already disarmed");
+        ::close(timerfd);
+        timerfd = -1;
+        ProbeScheduler::instance().releasePhase(adapter);
+    }
+
+  private:
+    template <typename Rep, typename Period>
+    void expireAfter(std::chrono::duration<Rep, Period> after)
+    {
+        auto delay = std::max(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(after),
+            std::chrono::nanoseconds(1));
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(delay);
+        struct itimerspec expiry{
+            {0, 0}, {seconds.count(), (delay - seconds).count()}};
+
+        int rc = ::timerfd_settime(timerfd, 0, &expiry, nullptr);
+        if (rc == -1)
+        {
+            lg2::error("Failed to set expiry for timerfd: {ERRNO_DESCRIPTION}",
+                       "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO", errno);
+        }
+    }
+
+    const char* pollClass = PollPolicies::defaultClass;
+    PollPolicy policy;
+    std::chrono::milliseconds current{};
+    int adapter = ProbeScheduler::noAdapter;
+    double phase = 1.0;
+    int timerfd = -1;
+};
+
+template <DerivesDevice T, PresenceProbe P>
+class PolledDevicePresence : public NotifySink
+{
+  public:
+    PolledDevicePresence() = delete;
+    PolledDevicePresence(Connector<T>* connector, P&& poll) :
+        connector(connector), poll(std::move(poll)), timer(pollClassFor<T>())
+    {
+        model.unsettled.set(0);
+    }
+    PolledDevicePresence(const PolledDevicePresence& other) = default;
+    PolledDevicePresence(PolledDevicePresence&& other) noexcept = default;
+    virtual ~PolledDevicePresence() = default;
+
+    PolledDevicePresence&
+        operator=(const PolledDevicePresence& other) = default;
+    PolledDevicePresence&
+        operator=(PolledDevicePresence&& other) noexcept = default;
+
+    /* NotifySink */
+    void arm() override
+    {
+        timer.arm();
+    }
+
+    int getFD() override
+    {
+        return timer.getFD();
+    }
+
+    void notify(Notifier& notifier) override
+    {
+        const PresenceBitmap<1> previous = model.observed;
+
+        timer.drain();
+        connector->verify(notifier);
+        sample(notifier);
+        timer.schedule(!(model.observed == previous) || model.settling.any());
+    }
+
+    void disarm() override
+    {
+        timer.disarm();
+    }
+
+    void rescan() override
+    {
+        timer.rescan();
+    }
+
+    void sample(Notifier& notifier)
+    {
+        PresenceBitmap<1> sampled;
+        sampled.set(0);
+
+        model.observed.set(0, poll());
+        if (model.debounce(sampled, debouncePolicyFor<T>()).any())
+        {
+            connector->flapped(notifier, model.flaps.at(0));
+        }
+        model.unsettled.reset(0);
+
+        if (model.debounced.test(0))
+        {
+            try
+            {
+                connector->populate(notifier);
+            }
+            catch (const SysfsI2CDeviceDriverBindException& ex)
+            {
+                lg2::error(
+                    "Failed to bind driver for device reporting present, disabling notifier: {EXCEPTION}",
+                    "EXCEPTION", ex);
+                notifier.remove(this);
+            }
+        }
+        else
+        {
+            connector->depopulate(notifier);
+        }
+    }
+
+    const PresenceModel<1>& getPresence() const
+    {
+        return model;
+    }
+
+  private:
     Connector<T>* connector;
-    std::function<bool()> poll;
-    int timerfd;
+    P poll;
+    PresenceModel<1> model;
+    PollTimer timer;
 };
 
-template <DerivesDevice T>
+template <DerivesDevice T, PresenceProbe P>
 class PolledConnector
 {
   public:
@@ -255,12 +546,41 @@ class PolledConnector
     PolledConnector& operator=(const PolledConnector& other) = delete;
     PolledConnector& operator=(PolledConnector&& other) = delete;
 
-    void start(Notifier& notifier, std::function<bool()>&& probe)
+    void start(Notifier& notifier, P&& probe)
     {
-        poller.emplace(&connector, probe);
+        poller.emplace(&connector, std::move(probe));
         notifier.add(&poller.value());
     }
 
+    /* Take a sample immediately rather than wait for the timer to expire */
+    void sample(Notifier& notifier)
+    {
+        if (!poller)
+        {
+            return;
+        }
+
+        /* Mirror the handling of exceptions in Notifier::run() */
+        try
+        {
+            poller->sample(notifier);
+        }
+        catch (const std::exception& ex)
+        {
+            lg2::error(
+                "Unhandled exception sampling connector, disabling poller: {EXCEPTION}",
+                "EXCEPTION", ex);
+            notifier.remove(&poller.value());
+        }
+        catch (const std::error_condition& err)
+        {
+            lg2::error(
+                "Unhandled error condition sampling connector, disabling poller: {ERROR}",
+                "ERROR", err.value());
+            notifier.remove(&poller.value());
+        }
+    }
+
     void stop(Notifier& notifier, int mode)
     {
         if (poller)
@@ -276,9 +596,360 @@ class PolledConnector
         return connector.index();
     }
 
+    /* The debounced presence and flap count, if started */
+    const PresenceModel<1>* getPresence() const
+    {
+        return poller ? &poller->getPresence() : nullptr;
+    }
+
+    void identify(ConnectorID id)
+    {
+        connector.identify(id);
+    }
+
   private:
     Connector<T> connector;
-    std::optional<PolledDevicePresence<T>> poller;
+    std::optional<PolledDevicePresence<T, P>> poller;
+};
+
+/*
+ * Polls a fixed set of connectors from a single timer. Each tick samples the
+ * started probes into the observed bitmap, and only the connectors whose
+ * presence differs from what was last published are populated or depopulated.
+ * The transitions run concurrently if a WorkPool is attached.
+ *
+ * BusProbes are sampled in bus order so those behind the same mux are visited
+ * together. A settled probe that would exceed its adapter's budget keeps its
+ * last observation and is deferred to the next tick, which then starts with
+ * it and runs at the policy's interval so the deferral can't starve it.
+ */
+template <DerivesDevice T, PresenceProbe P, std::size_t N>
+class PolledConnectorArray : public NotifySink
+{
+  public:
+    PolledConnectorArray() = delete;
+    /* make(index) constructs the connector at index */
+    template <typename F>
+        requires std::same_as<std::invoke_result_t<F&, int>, Connector<T>>
+    explicit PolledConnectorArray(F&& make) :
+        PolledConnectorArray(make, std::make_index_sequence<N>())
+    {}
+    PolledConnectorArray(const PolledConnectorArray& other) = delete;
+    PolledConnectorArray(PolledConnectorArray&& other) = delete;
+    virtual ~PolledConnectorArray() = default;
+
+    PolledConnectorArray& operator=(const PolledConnectorArray& other) = delete;
+    PolledConnectorArray& operator=(PolledConnectorArray&& other) = delete;
+
+    static constexpr std::size_t size()
+    {
+        return N;
+    }
+
+    /* Publish transitions against consecutive IDs starting from first */
+    void identify(ConnectorID first)
+    {
+        for (std::size_t index = 0; index < N; index++)
+        {
+            connectors.at(index).identify(
+                static_cast<ConnectorID>(first + index));
+        }
+    }
+
+    void start(Notifier& notifier, std::size_t index, P&& probe)
+    {
+        probes.at(index).emplace(std::move(probe));
+        started.set(index);
+        model.unsettled.set(index);
+
+        if constexpr (BusProbe<P>)
+        {
+            std::ranges::stable_sort(order, {}, [this](std::size_t index) {
+                const std::optional<P>& probe = probes.at(index);
+                return probe ? probe->getBus()
+                             : std::numeric_limits<int>::max();
+            });
+        }
+
+        if (timer.getFD() == -1)
+        {
+            notifier.add(this);
+        }
+    }
+
+    /* Take a sample immediately rather than wait for the timer to expire */
+    void sample(Notifier& notifier)
+    {
+        const PresenceBitmap<N> sampled = started;
+        std::size_t resume = 0;
+
+        deferred.clear();
+        for (std::size_t step = 0; step < N; step++)
+        {
+            const std::size_t position = (cursor + step) % N;
+            const std::size_t index = order.at(position);
+
+            if (!sampled.test(index))
+            {
+                continue;
+            }
+
+            if (isOverBudget(index))
+            {
+                if (!deferred.any())
+                {
+                    resume = position;
+                }
+                deferred.set(index);
+                continue;
+            }
+
+            observe(index);
+        }
+        cursor = resume;
+
+        /* Deferred probes weren't sampled, so don't advance their streaks */
+        const PresenceBitmap<N> flapped = model.debounce(
+            (sampled & started) ^ deferred, debouncePolicyFor<T>());
+        flapped.forEach([this, &notifier](std::size_t index) {
+            connectors.at(index).flapped(notifier, model.flaps.at(index));
+        });
+
+        const PresenceBitmap<N> pending = model.pending() & started;
+        if (pending.any())
+        {
+            apply(notifier, pending);
+        }
+    }
+
+    void stop(Notifier& notifier, int mode)
+    {
+        notifier.remove(this);
+
+        for (auto& probe : probes)
+        {
+            probe.reset();
+        }
+        started.clear();
+        deferred.clear();
+        adopted.clear();
+        cursor = 0;
+        model.clear();
+
+        for (auto& connector : connectors)
+        {
+            connector.depopulate(notifier, mode);
+        }
+    }
+
+    const PresenceModel<N>& getPresence() const
+    {
+        return model;
+    }
+
+    /* NotifySink */
+    void arm() override
+    {
+        int adapter = ProbeScheduler::noAdapter;
+
+        if constexpr (BusProbe<P>)
+        {
+            started.forEach([this, &adapter](std::size_t index) {
+                if (adapter == ProbeScheduler::noAdapter)
+                {
+                    adapter = probes.at(index)->getAdapter();
+                }
+            });
+        }
+
+        timer.arm(adapter);
+    }
+
+    int getFD() override
+    {
+        return timer.getFD();
+    }
+
+    void notify(Notifier& notifier) override
+    {
+        const PresenceBitmap<N> previous = model.observed;
+
+        timer.drain();
+        verify(notifier);
+        sample(notifier);
+        timer.schedule(!(model.observed == previous) ||
+                       model.settling.any() || deferred.any());
+    }
+
+    void disarm() override
+    {
+        timer.disarm();
+    }
+
+    void rescan() override
+    {
+        timer.rescan();
+    }
+
+  private:
+    /*
+     * Keep the spawned closures within the small-object buffer of
+     * std::function so ticks with transitions don't allocate
+     */
+    struct Transitions
+    {
+        PolledConnectorArray* connectors;
+        Notifier* notifier;
+        std::array<bool, N> applied;
+    };
+
+    template <typename F, std::size_t... Index>
+    PolledConnectorArray(F& make, std::index_sequence<Index...> /* indices */) :
+        connectors{{make(static_cast<int>(Index))...}}, probes(), model(),
+        started(), deferred(), order{{Index...}}, timer(pollClassFor<T>())
+    {}
+
+    /* Defer settled probes that would exceed their adapter's budget */
+    bool isOverBudget([[maybe_unused]] std::size_t index)
+    {
+        if constexpr (BusProbe<P>)
+        {
+            const P& probe = *probes.at(index);
+
+            return !model.unsettled.test(index) && probe.usesBus() &&
+                   !ProbeScheduler::instance().tryAcquire(probe.getAdapter());
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    void observe(std::size_t index)
+    {
+        /* Mirror the handling of exceptions in Notifier::run() */
+        try
+        {
+            model.observed.set(index, (*probes.at(index))());
+        }
+        catch (const std::exception& ex)
+        {
+            lg2::error(
+                "Unhandled exception sampling connector {CONNECTOR_INDEX}, disabling its probe: {EXCEPTION}",
+                "CONNECTOR_INDEX", index, "EXCEPTION", ex);
+            disable(index);
+        }
+        catch (const std::error_condition& err)
+        {
+            lg2::error(
+                "Unhandled error condition sampling connector {CONNECTOR_INDEX}, disabling its probe: {ERROR}",
+                "CONNECTOR_INDEX", index, "ERROR", err.value());
+            disable(index);
+        }
+    }
+
+    void apply(Notifier& notifier, const PresenceBitmap<N>& pending)
+    {
+        Transitions transitions{this, &notifier, {}};
+
+        {
+            TaskGroup group;
+
+            pending.forEach([&transitions, &group](std::size_t index) {
+                group.spawn([&transitions, index]() {
+                    transitions.applied.at(index) =
+                        transitions.connectors->transition(
+                            *transitions.notifier, index);
+                });
+            });
+
+            group.wait();
+        }
+
+        pending.forEach([this, &transitions](std::size_t index) {
+            if (transitions.applied.at(index))
+            {
+                model.published.set(index, model.debounced.test(index));
+                model.unsettled.reset(index);
+                adopted.set(index, connectors.at(index).isAdopted());
+            }
+            else
+            {
+                disable(index);
+            }
+        });
+    }
+
+    void verify(Notifier& notifier)
+    {
+        const PresenceBitmap<N> unverified = adopted;
+
+        adopted.clear();
+        unverified.forEach([this, &notifier](std::size_t index) {
+            Connector<T>& connector = connectors.at(index);
+
+            connector.verify(notifier);
+            adopted.set(index, connector.isAdopted());
+        });
+    }
+
+    bool transition(Notifier& notifier, std::size_t index)
+    {
+        try
+        {
+            if (model.debounced.test(index))
+            {
+                connectors.at(index).populate(notifier);
+            }
+            else
+            {
+                connectors.at(index).depopulate(notifier);
+            }
+
+            return true;
+        }
+        catch (const SysfsI2CDeviceDriverBindException& ex)
+        {
+            lg2::error(
+                "Failed to bind driver for device reporting present on connector {CONNECTOR_INDEX}, disabling its probe: {EXCEPTION}",
+                "CONNECTOR_INDEX", index, "EXCEPTION", ex);
+        }
+        catch (const std::exception& ex)
+        {
+            lg2::error(
+                "Unhandled exception updating connector {CONNECTOR_INDEX}, disabling its probe: {EXCEPTION}",
+                "CONNECTOR_INDEX", index, "EXCEPTION", ex);
+        }
+        catch (const std::error_condition& err)
+        {
+            lg2::error(
+                "Unhandled error condition updating connector {CONNECTOR_INDEX}, disabling its probe: {ERROR}",
+                "CONNECTOR_INDEX", index, "ERROR", err.value());
+        }
+
+        return false;
+    }
+
+    void disable(std::size_t index)
+    {
+        probes.at(index).reset();
+        started.reset(index);
+        model.reset(index);
+    }
+
+    std::array<Connector<T>, N> connectors;
+    std::array<std::optional<P>, N> probes;
+    PresenceModel<N> model;
+    /* The connectors with a probe */
+    PresenceBitmap<N> started;
+    /* The probes skipped by the last sample for want of bus budget */
+    PresenceBitmap<N> deferred;
+    /* Connectors adopted from a previous instance, verified on the next tick */
+    PresenceBitmap<N> adopted;
+    /* The order in which to sample, and the position to start from */
+    std::array<std::size_t, N> order;
+    std::size_t cursor = 0;
+    PollTimer timer;
 };
 
 class Platform;
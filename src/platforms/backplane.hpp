@@ -0,0 +1,354 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include "devices/nvme.hpp"
+#include "inventory.hpp"
+#include "platform.hpp"
+#include "sysfs/gpio.hpp"
+#include "sysfs/i2c.hpp"
+
+#include <gpiod.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <array>
+#include <cerrno>
+#include <concepts>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Drive backplanes that report drive presence through the lines of a GPIO
+ * expander differ only in their bus topology and inventory layout. A
+ * backplane is described by a traits struct providing:
+ *
+ * - name: The backplane name used in log messages
+ * - driveEndpoint: Whether drive presence also requires the basic NVMe
+ *   management endpoint to respond, and whether the drive's VPD is published
+ * - qualifiedDriveNames: Whether drive inventory names carry the backplane
+ *   index, e.g. dp0_drive3 rather than drive3
+ * - driveConnectorIDBase: The presence table ID of the first drive connector
+ * - drivePresenceDeviceType, drivePresenceDeviceAddress: The GPIO expander
+ * - drivePresenceMap: The expander line for each drive connector
+ * - getDrivePresenceBus(instance): The bus hosting the GPIO expander
+ * - getDriveBus(instance, index): The management bus for a drive, only
+ *   required with driveEndpoint
+ */
+template <typename Traits>
+concept GpioPresenceBackplaneTraits = requires(int instance) {
+    { Traits::name } -> std::convertible_to<const char*>;
+    { Traits::driveEndpoint } -> std::convertible_to<bool>;
+    { Traits::qualifiedDriveNames } -> std::convertible_to<bool>;
+    { Traits::driveConnectorIDBase } -> std::convertible_to<ConnectorID>;
+    { Traits::drivePresenceDeviceType } -> std::convertible_to<const char*>;
+    { Traits::drivePresenceDeviceAddress } -> std::convertible_to<int>;
+    { Traits::drivePresenceMap.size() } -> std::convertible_to<std::size_t>;
+    { Traits::getDrivePresenceBus(instance) } -> std::same_as<SysfsI2CBus>;
+} && (!Traits::driveEndpoint || requires(int instance, int index) {
+    { Traits::getDriveBus(instance, index) } -> std::same_as<SysfsI2CBus>;
+});
+
+template <GpioPresenceBackplaneTraits Traits>
+class GpioPresenceBackplane;
+
+template <GpioPresenceBackplaneTraits Traits>
+class GpioPresenceNVMeDrive : public NVMeDrive, public Device, public FRU
+{
+  public:
+    GpioPresenceNVMeDrive(Inventory* inventory,
+                          const GpioPresenceBackplane<Traits>* backplane,
+                          int index) :
+        inventory(inventory), backplane(backplane), index(index)
+    {}
+    GpioPresenceNVMeDrive(const GpioPresenceNVMeDrive& other) = delete;
+    GpioPresenceNVMeDrive(GpioPresenceNVMeDrive&& other) = delete;
+    virtual ~GpioPresenceNVMeDrive() = default;
+
+    GpioPresenceNVMeDrive&
+        operator=(const GpioPresenceNVMeDrive& other) = delete;
+    GpioPresenceNVMeDrive& operator=(GpioPresenceNVMeDrive&& other) = delete;
+
+    /* Device */
+    void plug([[maybe_unused]] Notifier& notifier) override
+    {
+        if constexpr (Traits::driveEndpoint)
+        {
+            drive.emplace(backplane->getDriveBus(index), getInventoryPath());
+        }
+        addToInventory(inventory);
+        lg2::debug("Drive {NVME_ID} plugged on {BACKPLANE} {BACKPLANE_ID}",
+                   "NVME_ID", index, "BACKPLANE", Traits::name,
+                   "BACKPLANE_ID", backplane->getIndex());
+    }
+
+    uint32_t getFingerprint() const override
+    {
+        if constexpr (Traits::driveEndpoint)
+        {
+            return drive ? drive->getFingerprint() : 0;
+        }
+
+        return 0;
+    }
+
+    void adopt([[maybe_unused]] Notifier& notifier,
+               uint32_t fingerprint) override
+    {
+        if constexpr (Traits::driveEndpoint)
+        {
+            drive.emplace(getInventoryPath(), fingerprint);
+        }
+        lg2::debug("Drive {NVME_ID} adopted on {BACKPLANE} {BACKPLANE_ID}",
+                   "NVME_ID", index, "BACKPLANE", Traits::name,
+                   "BACKPLANE_ID", backplane->getIndex());
+    }
+
+    void verify([[maybe_unused]] Notifier& notifier) override
+    {
+        if constexpr (Traits::driveEndpoint)
+        {
+            if (drive && !drive->verify(backplane->getDriveBus(index)))
+            {
+                lg2::info(
+                    "Drive {NVME_ID} on {BACKPLANE} {BACKPLANE_ID} changed across the restart",
+                    "NVME_ID", index, "BACKPLANE", Traits::name,
+                    "BACKPLANE_ID", backplane->getIndex());
+                addToInventory(inventory);
+            }
+        }
+    }
+
+    void unplug([[maybe_unused]] Notifier& notifier,
+                int mode = UNPLUG_REMOVES_INVENTORY) override
+    {
+        try
+        {
+            if constexpr (Traits::driveEndpoint)
+            {
+                if (!drive)
+                {
+                    /* Cold-unplug, no drive is present */
+                    drive.emplace(getInventoryPath());
+                }
+            }
+            if (mode == UNPLUG_REMOVES_INVENTORY)
+            {
+                removeFromInventory(inventory);
+            }
+            drive.reset();
+            lg2::debug(
+                "Drive {NVME_ID} unplugged on {BACKPLANE} {BACKPLANE_ID}",
+                "NVME_ID", index, "BACKPLANE", Traits::name, "BACKPLANE_ID",
+                backplane->getIndex());
+        }
+        catch (const NoSuchInventoryItem& e)
+        {
+            drive.reset();
+            lg2::debug(
+                "Failed to remove drive {NVME_ID} on {BACKPLANE} {BACKPLANE_ID} from inventory, ignoring: {EXCEPTION}",
+                "NVME_ID", index, "BACKPLANE", Traits::name, "BACKPLANE_ID",
+                backplane->getIndex(), "EXCEPTION", e);
+        }
+    }
+
+    /* FRU */
+    const std::string& getInventoryPath() const override
+    {
+        return backplane->getDriveInventoryPath(index);
+    }
+
+    void addToInventory(Inventory* inventory) override
+    {
+        if constexpr (Traits::driveEndpoint)
+        {
+            drive->addToInventory(inventory);
+        }
+        inventory->markPresent(getInventoryPath());
+    }
+
+    void removeFromInventory(Inventory* inventory) override
+    {
+        inventory->markAbsent(getInventoryPath());
+        if constexpr (Traits::driveEndpoint)
+        {
+            drive->removeFromInventory(inventory);
+        }
+    }
+
+  private:
+    Inventory* inventory;
+    const GpioPresenceBackplane<Traits>* backplane;
+    int index;
+    std::optional<BasicNVMeDrive> drive;
+};
+
+/*
+ * Concrete backplanes derive from the template to describe where they sit in
+ * the inventory. The inventory paths for the backplane's drives are derived
+ * from the backplane's path when it is constructed.
+ */
+template <GpioPresenceBackplaneTraits Traits>
+class GpioPresenceBackplane : public Device, public FRU
+{
+  public:
+    static constexpr std::size_t drives = Traits::drivePresenceMap.size();
+
+    /* Let the presence of a reseated cable settle */
+    static constexpr DebouncePolicy debounce{2, 2};
+    static constexpr const char* pollClass = "backplane";
+
+    using Drive = GpioPresenceNVMeDrive<Traits>;
+    using DrivePresence =
+        std::conditional_t<Traits::driveEndpoint, NVMeDrivePresence,
+                           GpioLinePresence>;
+    using DriveConnectors = PolledConnectorArray<Drive, DrivePresence, drives>;
+
+    GpioPresenceBackplane(Inventory* inventory, int instance,
+                          std::string&& inventoryPath) :
+        GpioPresenceBackplane(inventory, instance, std::move(inventoryPath),
+                              std::make_index_sequence<drives>())
+    {}
+    GpioPresenceBackplane(const GpioPresenceBackplane& other) = delete;
+    GpioPresenceBackplane(GpioPresenceBackplane&& other) = delete;
+    virtual ~GpioPresenceBackplane() = default;
+
+    GpioPresenceBackplane&
+        operator=(const GpioPresenceBackplane& other) = delete;
+    GpioPresenceBackplane& operator=(GpioPresenceBackplane&& other) = delete;
+
+    int getIndex() const
+    {
+        return instance;
+    }
+
+    SysfsI2CBus getDriveBus(int index) const
+    {
+        return Traits::getDriveBus(instance, index);
+    }
+
+    const std::string& getDriveInventoryPath(int index) const
+    {
+        return driveInventoryPaths.at(index);
+    }
+
+    /* Device */
+    void plug(Notifier& notifier) override
+    {
+        StartupReport::Phase phase = notifier.startupPhase(
+            "Plugging " + std::string(Traits::name) + " drive backplane " +
+            std::to_string(instance));
+        SysfsI2CBus bus = Traits::getDrivePresenceBus(instance);
+        SysfsI2CDevice dev =
+            bus.probeDevice(Traits::drivePresenceDeviceType,
+                            Traits::drivePresenceDeviceAddress);
+
+        std::string chipDevice = SysfsGPIOChip(dev).getDevice().string();
+        gpiod::chip chip(chipDevice, gpiod::chip::OPEN_BY_PATH);
+
+        for (std::size_t index = 0; index < drives; index++)
+        {
+            auto line = chip.get_line(Traits::drivePresenceMap.at(index));
+            line.request({program_invocation_short_name,
+                          gpiod::line::DIRECTION_INPUT,
+                          gpiod::line::ACTIVE_LOW});
+            if constexpr (Traits::driveEndpoint)
+            {
+                driveConnectors.start(
+                    notifier, index,
+                    NVMeDrivePresence(std::move(line),
+                                      getDriveBus(static_cast<int>(index))));
+            }
+            else
+            {
+                driveConnectors.start(notifier, index,
+                                      GpioLinePresence(std::move(line)));
+            }
+        }
+
+        driveConnectors.sample(notifier);
+
+        lg2::debug("Plugged {BACKPLANE} drive backplane {BACKPLANE_ID}",
+                   "BACKPLANE", Traits::name, "BACKPLANE_ID", instance);
+    }
+
+    void unplug(Notifier& notifier,
+                int mode = Device::UNPLUG_REMOVES_INVENTORY) override
+    {
+        driveConnectors.stop(notifier, mode);
+
+        if (mode != Device::UNPLUG_RETAINS_DEVICES)
+        {
+            try
+            {
+                SysfsI2CBus bus = Traits::getDrivePresenceBus(instance);
+
+                bus.removeDevice(Traits::drivePresenceDeviceAddress);
+            }
+            catch (const std::error_condition& err)
+            {
+                if (err.value() != ENOENT)
+                {
+                    throw err;
+                }
+            }
+        }
+
+        lg2::debug("Unplugged {BACKPLANE} drive backplane {BACKPLANE_ID}",
+                   "BACKPLANE", Traits::name, "BACKPLANE_ID", instance);
+    }
+
+    /* FRU */
+    const std::string& getInventoryPath() const override
+    {
+        return inventoryPath;
+    }
+
+    void addToInventory([[maybe_unused]] Inventory* inventory) override
+    {
+        throw std::logic_error("Not implemented");
+    }
+
+    void removeFromInventory([[maybe_unused]] Inventory* inventory) override
+    {
+        throw std::logic_error("Not implemented");
+    }
+
+  private:
+    template <std::size_t... Index>
+    GpioPresenceBackplane(Inventory* inventory, int instance,
+                          std::string&& inventoryPath,
+                          std::index_sequence<Index...> /* indices */) :
+        instance(instance), inventoryPath(std::move(inventoryPath)),
+        driveInventoryPaths{{makeDriveInventoryPath(
+            static_cast<int>(Index))...}},
+        driveConnectors([this, inventory](int index) {
+            return Connector<Drive>(index, inventory, this, index);
+        })
+    {
+        driveConnectors.identify(Traits::driveConnectorIDBase +
+                                 instance * drives);
+    }
+
+    std::string makeDriveInventoryPath(int index) const
+    {
+        std::string path = inventoryPath + "/" + "nvme" +
+                           std::to_string(index) + "/";
+
+        // https://github.com/ibm-openbmc/openbmc/commit/f2c8a292e46a55705606ff346bdc1ffd9f4628d7
+        if constexpr (Traits::qualifiedDriveNames)
+        {
+            path += "dp" + std::to_string(instance) + "_";
+        }
+
+        return path + "drive" + std::to_string(index);
+    }
+
+    int instance;
+    const std::string inventoryPath;
+    const std::array<std::string, drives> driveInventoryPaths;
+    DriveConnectors driveConnectors;
+};
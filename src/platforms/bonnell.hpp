@@ -1,42 +1,29 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 #pragma once
 
-#include "devices/nvme.hpp"
 #include "platform.hpp"
+#include "platforms/backplane.hpp"
 
-class Driskill;
 class Pennybacker;
 
-class DriskillNVMeDrive : public NVMeDrive, public Device, public FRU
+struct DriskillTraits
 {
-  public:
-    DriskillNVMeDrive(Inventory* inventory, const Driskill* driskill,
-                      int index);
-    DriskillNVMeDrive(const DriskillNVMeDrive& other) = delete;
-    DriskillNVMeDrive(DriskillNVMeDrive&& other) = delete;
-    virtual ~DriskillNVMeDrive() = default;
-
-    DriskillNVMeDrive& operator=(const DriskillNVMeDrive& other) = delete;
-    DriskillNVMeDrive& operator=(DriskillNVMeDrive&& other) = delete;
+    static constexpr const char* name = "Driskill";
+    static constexpr bool driveEndpoint = true;
+    static constexpr bool qualifiedDriveNames = true;
 
-    /* Device */
-    void plug(Notifier& notifier) override;
-    void unplug(Notifier& notifier,
-                int mode = UNPLUG_REMOVES_INVENTORY) override;
+    /* Follows the Driskill connector, see Pennybacker */
+    static constexpr ConnectorID driveConnectorIDBase = 1;
 
-    /* FRU */
-    std::string getInventoryPath() const override;
-    void addToInventory(Inventory* inventory) override;
-    void removeFromInventory(Inventory* inventory) override;
+    static constexpr const char* drivePresenceDeviceType = "pca9849";
+    static constexpr int drivePresenceDeviceAddress = 0x60;
+    static constexpr std::array<int, 4> drivePresenceMap = {4, 5, 6, 7};
 
-  private:
-    Inventory* inventory;
-    const Driskill* driskill;
-    int index;
-    std::optional<BasicNVMeDrive> drive;
+    static SysfsI2CBus getDrivePresenceBus(int instance);
+    static SysfsI2CBus getDriveBus(int instance, int index);
 };
 
-class Driskill : public Device, public FRU
+class Driskill : public GpioPresenceBackplane<DriskillTraits>
 {
   public:
     explicit Driskill(Inventory* inventory, const Pennybacker* pennybacker);
@@ -46,25 +33,6 @@ class Driskill : public Device, public FRU
 
     Driskill& operator=(const Driskill& other) = delete;
     Driskill& operator=(const Driskill&& other) = delete;
-
-    static SysfsI2CBus getDriveBus(int driveIndex);
-
-    /* Device */
-    void plug(Notifier& notifier) override;
-    void unplug(Notifier& notifier,
-                int mode = Device::UNPLUG_REMOVES_INVENTORY) override;
-
-    /* FRU */
-    std::string getInventoryPath() const override;
-    void addToInventory(Inventory* inventory) override;
-    void removeFromInventory(Inventory* inventory) override;
-
-  private:
-    static constexpr int drivePresenceDeviceAddress = 0x60;
-    static constexpr std::array<int, 4> drivePresenceMap = {4, 5, 6, 7};
-
-    const Pennybacker* pennybacker;
-    std::array<PolledConnector<DriskillNVMeDrive>, 4> polledDriveConnectors;
 };
 
 class Pennybacker : public Device, public FRU
@@ -87,11 +55,14 @@ class Pennybacker : public Device, public FRU
                 int mode = Device::UNPLUG_REMOVES_INVENTORY) override;
 
     /* FRU */
-    std::string getInventoryPath() const override;
+    const std::string& getInventoryPath() const override;
     void addToInventory(Inventory* inventory) override;
     void removeFromInventory(Inventory* inventory) override;
 
   private:
+    /* The drive connectors follow, see Driskill */
+    static constexpr ConnectorID driskillConnectorID = 0;
+
     static constexpr const char* driskillPresenceDevicePath =
         "/sys/bus/i2c/devices/0-0020";
     static constexpr int driskillPresenceOffset = 7;
@@ -102,7 +73,7 @@ class Pennybacker : public Device, public FRU
     static constexpr std::array<int, 4> driveChannelMap = {0, 2, 1, 3};
 
     Inventory* inventory;
-    PolledConnector<Driskill> polledDriskillConnector;
+    PolledConnector<Driskill, GpioLinePresence> polledDriskillConnector;
 };
 
 class Bonnell : public Platform
@@ -2,6 +2,9 @@
 
 #include "platforms/bonnell.hpp"
 
+#include "inventory.hpp"
+#include "tasks.hpp"
+
 void Bonnell::enrollWith(PlatformManager& pm)
 {
     pm.enrollPlatform("Bonnell", this);
@@ -10,14 +13,20 @@ void Bonnell::enrollWith(PlatformManager& pm)
 
 void Bonnell::detectFrus(Notifier& notifier, Inventory* inventory)
 {
-    Pennybacker pennybacker(inventory);
+    SynchronisedInventoryDecorator synchronisedInventory(inventory);
+    Pennybacker pennybacker(&synchronisedInventory);
 
-    /* Cold-plug devices */
-    pennybacker.plug(notifier);
+    /* Cold-plug devices, probing independent buses concurrently */
+    {
+        StartupReport::Phase phase =
+            notifier.startupPhase("Cold-plugging devices");
+        WorkPool pool;
+        pennybacker.plug(notifier);
+    }
 
     /* Hot-plug devices */
     notifier.run();
 
     /* Clean up the application state but leave the inventory in-tact */
-    pennybacker.unplug(notifier, Pennybacker::UNPLUG_RETAINS_INVENTORY);
+    pennybacker.unplug(notifier, unplugModeForExit(notifier));
 }
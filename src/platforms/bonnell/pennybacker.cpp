@@ -7,7 +7,9 @@
 
 Pennybacker::Pennybacker(Inventory* inventory) :
     inventory(inventory), polledDriskillConnector(0, this->inventory, this)
-{}
+{
+    polledDriskillConnector.identify(driskillConnectorID);
+}
 
 SysfsI2CBus Pennybacker::getDrivePresenceBus()
 {
@@ -25,15 +27,15 @@ void Pennybacker::plug(Notifier& notifier)
 {
     std::filesystem::path path(Pennybacker::driskillPresenceDevicePath);
     SysfsGPIOChip sysfsChip(path);
-    gpiod::chip chip(sysfsChip.getName().string(), gpiod::chip::OPEN_BY_NAME);
+    gpiod::chip chip(sysfsChip.getDevice().string(), gpiod::chip::OPEN_BY_PATH);
 
     auto line = chip.get_line(Pennybacker::driskillPresenceOffset);
 
     line.request({program_invocation_short_name, gpiod::line::DIRECTION_INPUT,
                   gpiod::line::ACTIVE_LOW});
 
-    polledDriskillConnector.start(
-        notifier, [line = std::move(line)]() { return line.get_value(); });
+    polledDriskillConnector.start(notifier, GpioLinePresence(std::move(line)));
+    polledDriskillConnector.sample(notifier);
 }
 
 void Pennybacker::unplug(Notifier& notifier, int mode)
@@ -41,9 +43,11 @@ void Pennybacker::unplug(Notifier& notifier, int mode)
     polledDriskillConnector.stop(notifier, mode);
 }
 
-std::string Pennybacker::getInventoryPath() const
+const std::string& Pennybacker::getInventoryPath() const
 {
-    return "/system/chassis/motherboard";
+    static const std::string path = "/system/chassis/motherboard";
+
+    return path;
 }
 
 void Pennybacker::addToInventory([[maybe_unused]] Inventory* inventory)
@@ -1,74 +1,31 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 #pragma once
 
-#include "devices/nvme.hpp"
 #include "platform.hpp"
+#include "platforms/backplane.hpp"
 
 #include <gpiod.hpp>
 
-class Basecamp;
 class Bellavista;
 
-class BasecampNVMeDrive : public NVMeDrive, public Device, public FRU
+struct BasecampTraits
 {
-  public:
-    BasecampNVMeDrive(Inventory* inventory, const Basecamp* basecamp,
-                      int index);
-    BasecampNVMeDrive(const BasecampNVMeDrive& other) = delete;
-    BasecampNVMeDrive(BasecampNVMeDrive&& other) = delete;
-    virtual ~BasecampNVMeDrive() = default;
-
-    BasecampNVMeDrive& operator=(const BasecampNVMeDrive& other) = delete;
-    BasecampNVMeDrive& operator=(BasecampNVMeDrive&& other) = delete;
-
-    /* Device */
-    void plug(Notifier& notifier) override;
-    void unplug(Notifier& notifier,
-                int mode = UNPLUG_REMOVES_INVENTORY) override;
-
-    /* FRU */
-    std::string getInventoryPath() const override;
-    void addToInventory(Inventory* inventory) override;
-    void removeFromInventory(Inventory* inventory) override;
-
-  private:
-    Inventory* inventory;
-    const Basecamp* basecamp;
-    int index;
-    std::optional<BasicNVMeDrive> drive;
-};
+    static constexpr const char* name = "Basecamp";
+    static constexpr bool driveEndpoint = true;
+    static constexpr bool qualifiedDriveNames = false;
 
-class Basecamp : public Device, public FRU
-{
-  public:
-    static SysfsI2CBus getDriveBus(int index);
+    /* Follows the Basecamp connector, see Bellavista */
+    static constexpr ConnectorID driveConnectorIDBase = 1;
 
-    explicit Basecamp(Inventory* inventory, const Bellavista* bellavista);
-    Basecamp(const Basecamp& other) = delete;
-    Basecamp(const Basecamp&& other) = delete;
-    virtual ~Basecamp() = default;
-
-    Basecamp& operator=(const Basecamp& other) = delete;
-    Basecamp& operator=(const Basecamp&& other) = delete;
-
-    /* Device */
-    void plug(Notifier& notifier) override;
-    void unplug(Notifier& notifier,
-                int mode = Device::UNPLUG_REMOVES_INVENTORY) override;
-
-    /* FRU */
-    std::string getInventoryPath() const override;
-    void addToInventory(Inventory* inventory) override;
-    void removeFromInventory(Inventory* inventory) override;
+    static constexpr const char* drivePresenceDeviceType = "pca9552";
+    static constexpr int drivePresenceDeviceAddress = 0x61;
+    static constexpr std::array<int, 10> drivePresenceMap = {0, 1, 2, 3, 4,
+                                                             5, 6, 7, 8, 9};
 
-  private:
     static constexpr const char* driveMetadataBus =
         "/sys/bus/i2c/devices/i2c-14";
     static constexpr int driveMetadataMuxAddress = 0x70;
     static constexpr int driveMetadataMuxChannel = 3;
-    static constexpr int drivePresenceDeviceAddress = 0x61;
-    static constexpr std::array<int, 10> drivePresenceMap = {0, 1, 2, 3, 4,
-                                                             5, 6, 7, 8, 9};
 
     static constexpr const char* driveManagementBus =
         "/sys/bus/i2c/devices/i2c-15";
@@ -77,8 +34,20 @@ class Basecamp : public Device, public FRU
     static constexpr std::array<int, 10> driveChannelMap = {0, 1, 2, 3, 0,
                                                             1, 2, 3, 0, 1};
 
-    const Bellavista* bellavista;
-    std::array<PolledConnector<BasecampNVMeDrive>, 10> polledDriveConnectors;
+    static SysfsI2CBus getDrivePresenceBus(int instance);
+    static SysfsI2CBus getDriveBus(int instance, int index);
+};
+
+class Basecamp : public GpioPresenceBackplane<BasecampTraits>
+{
+  public:
+    explicit Basecamp(Inventory* inventory, const Bellavista* bellavista);
+    Basecamp(const Basecamp& other) = delete;
+    Basecamp(const Basecamp&& other) = delete;
+    virtual ~Basecamp() = default;
+
+    Basecamp& operator=(const Basecamp& other) = delete;
+    Basecamp& operator=(const Basecamp&& other) = delete;
 };
 
 class Bellavista : public Device, public FRU
@@ -98,17 +67,20 @@ class Bellavista : public Device, public FRU
                 int mode = Device::UNPLUG_REMOVES_INVENTORY) override;
 
     /* FRU */
-    std::string getInventoryPath() const override;
+    const std::string& getInventoryPath() const override;
     void addToInventory(Inventory* inventory) override;
     void removeFromInventory(Inventory* inventory) override;
 
   private:
+    /* The drive connectors follow, see Basecamp */
+    static constexpr ConnectorID basecampConnectorID = 0;
+
     static constexpr const char* basecampPresenceDevicePath =
         "/sys/bus/i2c/devices/0-0062";
     static constexpr int basecampPresenceOffset = 12;
 
     Inventory* inventory;
-    PolledConnector<Basecamp> polledBasecampConnector;
+    PolledConnector<Basecamp, GpioLinePresence> polledBasecampConnector;
 };
 
 class Tola : public Device
@@ -8,21 +8,23 @@
 
 Bellavista::Bellavista(Inventory* inventory) :
     inventory(inventory), polledBasecampConnector(0, this->inventory, this)
-{}
+{
+    polledBasecampConnector.identify(basecampConnectorID);
+}
 
 void Bellavista::plug(Notifier& notifier)
 {
     std::filesystem::path path(Bellavista::basecampPresenceDevicePath);
     SysfsGPIOChip sysfsChip(path);
-    gpiod::chip chip(sysfsChip.getName().string(), gpiod::chip::OPEN_BY_NAME);
+    gpiod::chip chip(sysfsChip.getDevice().string(), gpiod::chip::OPEN_BY_PATH);
 
     auto line = chip.get_line(Bellavista::basecampPresenceOffset);
 
     line.request({program_invocation_short_name, gpiod::line::DIRECTION_INPUT,
                   gpiod::line::ACTIVE_LOW});
 
-    polledBasecampConnector.start(
-        notifier, [line = std::move(line)]() { return line.get_value(); });
+    polledBasecampConnector.start(notifier, GpioLinePresence(std::move(line)));
+    polledBasecampConnector.sample(notifier);
 }
 
 void Bellavista::unplug(Notifier& notifier, int mode)
@@ -30,9 +32,11 @@ void Bellavista::unplug(Notifier& notifier, int mode)
     polledBasecampConnector.stop(notifier, mode);
 }
 
-std::string Bellavista::getInventoryPath() const
+const std::string& Bellavista::getInventoryPath() const
 {
-    return "/system/chassis/motherboard";
+    static const std::string path = "/system/chassis/motherboard";
+
+    return path;
 }
 
 void Bellavista::addToInventory([[maybe_unused]] Inventory* inventory)
@@ -3,6 +3,7 @@
 #include "platforms/everest.hpp"
 
 #include "inventory/migrations.hpp"
+#include "tasks.hpp"
 
 void Everest::enrollWith(PlatformManager& pm)
 {
@@ -12,17 +13,36 @@ void Everest::enrollWith(PlatformManager& pm)
 
 void Everest::detectFrus(Notifier& notifier, Inventory* inventory)
 {
-    Tola tola(inventory);
-
-    Inventory::migrate(inventory, inventory::MigrateNVMeIPZVPDFromSlotToDrive(),
-                       inventory::MigrateNVMeI2CEndpointFromSlotToDrive());
-
-    /* Cold-plug devices */
-    tola.plug(notifier);
+    SynchronisedInventoryDecorator synchronisedInventory(inventory);
+    Tola tola(&synchronisedInventory);
+
+    /*
+     * Cold-plug devices, probing independent buses concurrently. The
+     * migrations run alongside, and the inventory is held until they're done.
+     */
+    synchronisedInventory.hold();
+    {
+        StartupReport::Phase phase =
+            notifier.startupPhase("Cold-plugging devices");
+        WorkPool pool;
+        TaskGroup group;
+
+        group.spawn([&synchronisedInventory, &notifier]() {
+            StartupReport::Phase phase =
+                notifier.startupPhase("Migrating inventory");
+            Inventory::migrate(
+                &synchronisedInventory,
+                inventory::MigrateNVMeIPZVPDFromSlotToDrive(),
+                inventory::MigrateNVMeI2CEndpointFromSlotToDrive());
+        });
+        group.spawn([&tola, &notifier]() { tola.plug(notifier); });
+
+        group.wait();
+    }
 
     /* Hot-plug devices */
     notifier.run();
 
     /* Clean up the application state but leave the inventory in-tact. */
-    tola.unplug(notifier, Tola::UNPLUG_RETAINS_INVENTORY);
+    tola.unplug(notifier, unplugModeForExit(notifier));
 }
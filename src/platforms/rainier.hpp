@@ -6,6 +6,7 @@
 #include "inventory.hpp"
 #include "notify.hpp"
 #include "platform.hpp"
+#include "platforms/backplane.hpp"
 #include "sysfs/i2c.hpp"
 
 #include <gpiod.hpp>
@@ -13,6 +14,8 @@
 #include <array>
 #include <chrono>
 #include <map>
+#include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -40,9 +43,12 @@ class FlettNVMeDrive : public NVMeDrive, public Device, public FRU
     void plug(Notifier& notifier) override;
     void unplug(Notifier& notifier,
                 int mode = UNPLUG_REMOVES_INVENTORY) override;
+    uint32_t getFingerprint() const override;
+    void adopt(Notifier& notifier, uint32_t fingerprint) override;
+    void verify(Notifier& notifier) override;
 
     /* FRU */
-    std::string getInventoryPath() const override;
+    const std::string& getInventoryPath() const override;
     void addToInventory(Inventory* inventory) override;
     void removeFromInventory(Inventory* inventory) override;
 
@@ -57,9 +63,14 @@ class FlettNVMeDrive : public NVMeDrive, public Device, public FRU
 class Flett : public Device
 {
   public:
+    static constexpr const char* ccin = "6B87";
+
     static std::string getInventoryPathFor(const Nisqually* nisqually,
                                            int slot);
 
+    /* Identify the card in the slot from its EEPROM, if it can be read */
+    static std::optional<bool> isFlettAt(const Nisqually* nisqually, int slot);
+
     explicit Flett(Inventory* inventory, const Nisqually* nisqually, int slot);
     Flett(const Flett& other) = delete;
     Flett(const Flett&& other) = delete;
@@ -70,6 +81,7 @@ class Flett : public Device
 
     int getIndex() const;
     SysfsI2CBus getDriveBus(int index) const;
+    const std::string& getDriveInventoryPath(int index) const;
 
     /* Device */
     void plug(Notifier& notifier) override;
@@ -77,40 +89,43 @@ class Flett : public Device
                 int mode = Device::UNPLUG_REMOVES_INVENTORY) override;
 
   private:
+    using DriveConnectors =
+        PolledConnectorArray<FlettNVMeDrive, NVMeEndpointPresence, 8>;
+
+    /* Eight drive connectors for each of slots 8 to 11 */
+    static constexpr ConnectorID driveConnectorIDBase = 32;
+
     const Nisqually* nisqually;
     int slot;
-    std::array<PolledConnector<FlettNVMeDrive>, 8> polledDriveConnectors;
+    std::array<std::string, 8> driveInventoryPaths;
+    DriveConnectors driveConnectors;
 };
 
-class WilliwakasNVMeDrive : public NVMeDrive, public Device, public FRU
+struct WilliwakasTraits
 {
-  public:
-    explicit WilliwakasNVMeDrive(Inventory* inventory,
-                                 const Williwakas* williwakas, int index);
-    WilliwakasNVMeDrive(const WilliwakasNVMeDrive& other) = delete;
-    WilliwakasNVMeDrive(const WilliwakasNVMeDrive&& other) = delete;
-    virtual ~WilliwakasNVMeDrive() = default;
+    static constexpr const char* name = "Williwakas";
+    static constexpr bool driveEndpoint = false;
+    static constexpr bool qualifiedDriveNames = true;
 
-    WilliwakasNVMeDrive& operator=(const WilliwakasNVMeDrive& other) = delete;
-    WilliwakasNVMeDrive& operator=(const WilliwakasNVMeDrive&& other) = delete;
+    /* Eight drive connectors for each of the three backplanes */
+    static constexpr ConnectorID driveConnectorIDBase = 8;
 
-    /* Device */
-    void plug(Notifier& notifier) override;
-    void unplug(Notifier& notifier,
-                int mode = UNPLUG_REMOVES_INVENTORY) override;
+    static constexpr const char* drivePresenceDeviceType = "pca9552";
+    static constexpr int drivePresenceDeviceAddress = 0x60;
+    static constexpr std::array<int, 8> drivePresenceMap = {
+        8, 9, 10, 11, 12, 13, 14, 15,
+    };
 
-    /* FRU */
-    std::string getInventoryPath() const override;
-    void addToInventory(Inventory* inventory) override;
-    void removeFromInventory(Inventory* inventory) override;
+    static constexpr std::array<const char*, 3> driveBackplaneBus = {
+        "/sys/bus/i2c/devices/i2c-13",
+        "/sys/bus/i2c/devices/i2c-14",
+        "/sys/bus/i2c/devices/i2c-15",
+    };
 
-  private:
-    Inventory* inventory;
-    const Williwakas* williwakas;
-    int index;
+    static SysfsI2CBus getDrivePresenceBus(int instance);
 };
 
-class Williwakas : public Device, public FRU
+class Williwakas : public GpioPresenceBackplane<WilliwakasTraits>
 {
   public:
     static std::string getInventoryPathFor(const Nisqually* nisqually,
@@ -124,39 +139,6 @@ class Williwakas : public Device, public FRU
 
     Williwakas& operator=(const Williwakas& other) = delete;
     Williwakas& operator=(const Williwakas&& other) = delete;
-
-    int getIndex() const;
-
-    /* Device */
-    void plug(Notifier& notifier) override;
-    void unplug(Notifier& notifier,
-                int mode = Device::UNPLUG_REMOVES_INVENTORY) override;
-
-    /* FRU */
-    std::string getInventoryPath() const override;
-    void addToInventory(Inventory* inventory) override;
-    void removeFromInventory(Inventory* inventory) override;
-
-  private:
-    static constexpr int drivePresenceDeviceAddress = 0x60;
-
-    static constexpr std::array<const char*, 3> driveBackplaneBus = {
-        "/sys/bus/i2c/devices/i2c-13",
-        "/sys/bus/i2c/devices/i2c-14",
-        "/sys/bus/i2c/devices/i2c-15",
-    };
-
-    static constexpr std::array<int, 8> drivePresenceMap = {
-        8, 9, 10, 11, 12, 13, 14, 15,
-    };
-
-    Inventory* inventory;
-    const Nisqually* nisqually;
-    int index;
-    std::array<PolledConnector<WilliwakasNVMeDrive>, 8> polledDriveConnectors;
-
-    bool isDrivePresent(int index);
-    void detectDrives(Notifier& notifier);
 };
 
 class Nisqually : public Device, FRU
@@ -180,25 +162,40 @@ class Nisqually : public Device, FRU
                 int mode = Device::UNPLUG_REMOVES_INVENTORY) override;
 
     /* FRU */
-    std::string getInventoryPath() const override;
+    const std::string& getInventoryPath() const override;
     void addToInventory(Inventory* inventory) override;
     void removeFromInventory(Inventory* inventory) override;
 
   protected:
-    bool isFlettPresentAt(int slot);
+    bool isFlettPresentAt(int slot, bool identify);
 
     Inventory* inventory;
 
   private:
+    /*
+     * Connector IDs in the presence table are laid out as:
+     *
+     *  0 -  3: Flett cards, for PCIe slots 8 to 11
+     *  4 -  6: Williwakas backplanes
+     *  8 - 31: Williwakas drives, see WilliwakasTraits::driveConnectorIDBase
+     * 32 - 63: Flett drives, see Flett::driveConnectorIDBase
+     */
+    static constexpr ConnectorID flettConnectorIDBase = 0;
+    static constexpr ConnectorID williwakasConnectorIDBase = 4;
+
     static constexpr const char* williwakasPresenceDevicePath =
         "/sys/bus/i2c/devices/0-0020";
     static constexpr std::array<int, 3> williwakasPresenceMap = {7, 6, 5};
 
     void detectFlettCards(Notifier& notifier);
+    void watchFlettCard(Notifier& notifier, int connector, int slot);
+    void detectFlettCard(Notifier& notifier, int connector, int slot,
+                         bool identify);
     void detectWilliwakasCards(Notifier& notifier);
 
     std::array<Connector<Flett>, 4> flettConnectors;
-    std::array<Connector<Williwakas>, 3> williwakasConnectors;
+    PolledConnectorArray<Williwakas, GpioLinePresence, 3> williwakasConnectors;
+    std::vector<std::weak_ptr<dbus::PropertiesChangedListener>> flettListeners;
 };
 
 class Nisqually0z : public Nisqually
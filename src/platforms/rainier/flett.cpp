@@ -1,8 +1,10 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 /* Copyright IBM Corp. 2021 */
 #include "devices/nvme.hpp"
+#include "devices/vpd.hpp"
 #include "inventory.hpp"
 #include "platforms/rainier.hpp"
+#include "sysfs/eeprom.hpp"
 #include "sysfs/gpio.hpp"
 #include "sysfs/i2c.hpp"
 
@@ -11,6 +13,7 @@
 #include <cassert>
 #include <cerrno>
 #include <map>
+#include <optional>
 #include <string>
 
 PHOSPHOR_LOG2_USING;
@@ -56,16 +59,32 @@ void FlettNVMeDrive::unplug([[maybe_unused]] Notifier& notifier, int mode)
     }
 }
 
-std::string FlettNVMeDrive::getInventoryPath() const
+uint32_t FlettNVMeDrive::getFingerprint() const
 {
-    // https://github.com/ibm-openbmc/openbmc/commit/f2c8a292e46a55705606ff346bdc1ffd9f4628d7
-    const std::string williwakasPath =
-        Williwakas::getInventoryPathFor(nisqually, flett->getIndex());
-    const std::string slotID = "nvme" + std::to_string(index);
-    const std::string backplaneID = "dp" + std::to_string(flett->getIndex());
-    const std::string driveID = "drive" + std::to_string(index);
-    const std::string compositeID = backplaneID + "_" + driveID;
-    return williwakasPath + "/" + slotID + "/" + compositeID;
+    return drive ? drive->getFingerprint() : 0;
+}
+
+void FlettNVMeDrive::adopt([[maybe_unused]] Notifier& notifier,
+                           uint32_t fingerprint)
+{
+    drive.emplace(getInventoryPath(), fingerprint);
+    debug("Drive {NVME_ID} adopted on Flett {FLETT_ID}", "NVME_ID", index,
+          "FLETT_ID", flett->getIndex());
+}
+
+void FlettNVMeDrive::verify([[maybe_unused]] Notifier& notifier)
+{
+    if (drive && !drive->verify(flett->getDriveBus(index)))
+    {
+        info("Drive {NVME_ID} on Flett {FLETT_ID} changed across the restart",
+             "NVME_ID", index, "FLETT_ID", flett->getIndex());
+        addToInventory(inventory);
+    }
+}
+
+const std::string& FlettNVMeDrive::getInventoryPath() const
+{
+    return flett->getDriveInventoryPath(index);
 }
 
 void FlettNVMeDrive::addToInventory(Inventory* inventory)
@@ -119,79 +138,147 @@ std::string Flett::getInventoryPathFor(const Nisqually* nisqually, int slot)
            std::to_string(slot) + "/" + "pcie_card" + std::to_string(slot);
 }
 
+std::optional<bool> Flett::isFlettAt(const Nisqually* nisqually, int slot)
+{
+    try
+    {
+        SysfsI2CBus bus = nisqually->getFlettSlotI2CBus(slot);
+        int address = flettSlotEepromMap.at(slot);
+
+        /*
+         * A Flett keeps its EEPROM bound until it's unplugged, so re-evaluating
+         * an identified card doesn't wait on the driver again
+         */
+        SysfsI2CDevice device = bus.isDevicePresent(address)
+                                    ? SysfsI2CDevice(bus, address)
+                                    : bus.probeDevice("24c02", address);
+
+        std::optional<std::string> model;
+        try
+        {
+            model = vpd::readCCIN(SysfsEEPROM(device));
+        }
+        catch (const std::error_condition& err)
+        {
+            debug("Failed to read EEPROM for slot {PCIE_SLOT}: {ERROR_MESSAGE}",
+                  "PCIE_SLOT", slot, "ERROR_MESSAGE", err.message());
+        }
+
+        if (!model || *model != ccin)
+        {
+            bus.removeDevice(address);
+        }
+
+        if (!model)
+        {
+            return std::nullopt;
+        }
+
+        debug("EEPROM reports the card in slot {PCIE_SLOT} has CCIN {CCIN}",
+              "PCIE_SLOT", slot, "CCIN", *model);
+
+        return *model == ccin;
+    }
+    catch (const SysfsI2CDeviceDriverBindException& ex)
+    {
+        debug("No EEPROM bound for slot {PCIE_SLOT}: {EXCEPTION}", "PCIE_SLOT",
+              slot, "EXCEPTION", ex);
+    }
+    catch (const std::error_condition& err)
+    {
+        debug("Failed to probe EEPROM for slot {PCIE_SLOT}: {ERROR_MESSAGE}",
+              "PCIE_SLOT", slot, "ERROR_MESSAGE", err.message());
+    }
+
+    return std::nullopt;
+}
+
 Flett::Flett(Inventory* inventory, const Nisqually* nisqually, int slot) :
-    nisqually(nisqually), slot(slot),
-    polledDriveConnectors{{
-        PolledConnector<FlettNVMeDrive>(0, inventory, this->nisqually, this,
-                                        flettChannelDriveMap.at(0)),
-        PolledConnector<FlettNVMeDrive>(1, inventory, this->nisqually, this,
-                                        flettChannelDriveMap.at(1)),
-        PolledConnector<FlettNVMeDrive>(2, inventory, this->nisqually, this,
-                                        flettChannelDriveMap.at(2)),
-        PolledConnector<FlettNVMeDrive>(3, inventory, this->nisqually, this,
-                                        flettChannelDriveMap.at(3)),
-        PolledConnector<FlettNVMeDrive>(4, inventory, this->nisqually, this,
-                                        flettChannelDriveMap.at(4)),
-        PolledConnector<FlettNVMeDrive>(5, inventory, this->nisqually, this,
-                                        flettChannelDriveMap.at(5)),
-        PolledConnector<FlettNVMeDrive>(6, inventory, this->nisqually, this,
-                                        flettChannelDriveMap.at(6)),
-        PolledConnector<FlettNVMeDrive>(7, inventory, this->nisqually, this,
-                                        flettChannelDriveMap.at(7)),
-    }}
-{}
+    nisqually(nisqually), slot(slot), driveInventoryPaths(),
+    driveConnectors([this, inventory](int index) {
+        return Connector<FlettNVMeDrive>(index, inventory, this->nisqually,
+                                         this, flettChannelDriveMap.at(index));
+    })
+{
+    // https://github.com/ibm-openbmc/openbmc/commit/f2c8a292e46a55705606ff346bdc1ffd9f4628d7
+    const std::string williwakasPath =
+        Williwakas::getInventoryPathFor(nisqually, getIndex());
+    const std::string backplaneID = "dp" + std::to_string(getIndex());
+
+    for (std::size_t i = 0; i < driveInventoryPaths.size(); i++)
+    {
+        const std::string slotID = "nvme" + std::to_string(i);
+        const std::string driveID = "drive" + std::to_string(i);
+        const std::string compositeID = backplaneID + "_" + driveID;
+
+        driveInventoryPaths.at(i) = williwakasPath + "/" + slotID + "/" +
+                                    compositeID;
+    }
+
+    driveConnectors.identify(driveConnectorIDBase +
+                             (slot - 8) * DriveConnectors::size());
+}
 
 int Flett::getIndex() const
 {
     return Nisqually::getFlettIndex(slot);
 }
 
-SysfsI2CBus Flett::getDriveBus(int index) const
+const std::string& Flett::getDriveInventoryPath(int index) const
 {
-    SysfsI2CMux flettMux(nisqually->getFlettSlotI2CBus(slot),
-                         flettSlotMuxMap.at(slot));
+    return driveInventoryPaths.at(index);
+}
 
-    return {flettMux, flettDriveChannelMap.at(index)};
+SysfsI2CBus Flett::getDriveBus(int index) const
+{
+    return SysfsI2CTopology::instance().getMuxChannel(
+        nisqually->getFlettSlotI2CBus(slot), flettSlotMuxMap.at(slot),
+        flettDriveChannelMap.at(index));
 }
 
 void Flett::plug(Notifier& notifier)
 {
     SysfsI2CBus bus = nisqually->getFlettSlotI2CBus(slot);
 
-#if 0 /* FIXME: Well, fix qemu */
-    bus.probeDevice("24c02", flettSlotEepromMap.at(slot));
-#endif
     bus.probeDevice("pca9548", flettSlotMuxMap.at(slot));
 
-    for (auto& poller : polledDriveConnectors)
+    for (std::size_t index = 0; index < DriveConnectors::size(); index++)
     {
-        const auto bus = getDriveBus(flettChannelDriveMap.at(poller.index()));
-        poller.start(notifier, [bus]() {
-            return BasicNVMeDrive::isBasicEndpointPresent(bus);
-        });
+        int channel = flettChannelDriveMap.at(static_cast<int>(index));
+        driveConnectors.start(notifier, index,
+                              NVMeEndpointPresence(getDriveBus(channel)));
     }
 
+    driveConnectors.sample(notifier);
+
     debug("Plugged Flett in slot {PCIE_SLOT}", "PCIE_SLOT", slot);
 }
 
 void Flett::unplug(Notifier& notifier, int mode)
 {
-    for (auto& poller : polledDriveConnectors)
-    {
-        poller.stop(notifier, mode);
-    }
+    driveConnectors.stop(notifier, mode);
 
-    try
+    if (mode != Device::UNPLUG_RETAINS_DEVICES)
     {
-        SysfsI2CBus bus = nisqually->getFlettSlotI2CBus(slot);
+        try
+        {
+            SysfsI2CBus bus = nisqually->getFlettSlotI2CBus(slot);
+            int eeprom = flettSlotEepromMap.at(slot);
 
-        bus.removeDevice(flettSlotMuxMap.at(slot));
-    }
-    catch (const std::error_condition& err)
-    {
-        if (err.value() != ENOENT)
+            /* Bound by isFlettAt() when the card was identified */
+            if (bus.isDevicePresent(eeprom))
+            {
+                bus.removeDevice(eeprom);
+            }
+
+            bus.removeDevice(flettSlotMuxMap.at(slot));
+        }
+        catch (const std::error_condition& err)
         {
-            throw err;
+            if (err.value() != ENOENT)
+            {
+                throw err;
+            }
         }
     }
 
@@ -2,6 +2,7 @@
 /* Copyright IBM Corp. 2021 */
 #include "devices/nvme.hpp"
 #include "inventory.hpp"
+#include "platforms.h"
 #include "platforms/rainier.hpp"
 #include "sysfs/gpio.hpp"
 #include "sysfs/i2c.hpp"
@@ -12,9 +13,10 @@
 #include <cassert>
 #include <cerrno>
 #include <filesystem>
-#include <ranges>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 
 PHOSPHOR_LOG2_USING;
 
@@ -59,25 +61,37 @@ Nisqually::Nisqually(Inventory* inventory) :
                               Connector<Flett>(10, this->inventory, this, 10),
                               Connector<Flett>(11, this->inventory, this, 11),
                           }},
-    williwakasConnectors{{
-        Connector<Williwakas>(0, this->inventory, this, 0),
-        Connector<Williwakas>(1, this->inventory, this, 1),
-        Connector<Williwakas>(2, this->inventory, this, 2),
-    }}
-{}
+    williwakasConnectors([this](int index) {
+        return Connector<Williwakas>(index, this->inventory, this, index);
+    })
+{
+    for (const auto& [connector, slot] : flettConnectorSlotMap)
+    {
+        flettConnectors.at(connector).identify(flettConnectorIDBase +
+                                               connector);
+    }
+
+    williwakasConnectors.identify(williwakasConnectorIDBase);
+}
 
 void Nisqually::plug(Notifier& notifier)
 {
-    detectFlettCards(notifier);
-    detectWilliwakasCards(notifier);
+    /* The Flett and Williwakas cards sit on independent buses */
+    TaskGroup group;
+    group.spawn([this, &notifier]() { detectFlettCards(notifier); });
+    group.spawn([this, &notifier]() { detectWilliwakasCards(notifier); });
+    group.wait();
 }
 
 void Nisqually::unplug(Notifier& notifier, int mode)
 {
-    for (auto& connector : williwakasConnectors)
+    for (auto& listener : flettListeners)
     {
-        connector.depopulate(notifier, mode);
+        inventory->removePropertiesChangedListener(listener);
     }
+    flettListeners.clear();
+
+    williwakasConnectors.stop(notifier, mode);
 
     for (auto& connector : flettConnectors)
     {
@@ -85,9 +99,11 @@ void Nisqually::unplug(Notifier& notifier, int mode)
     }
 }
 
-std::string Nisqually::getInventoryPath() const
+const std::string& Nisqually::getInventoryPath() const
 {
-    return "/system/chassis/motherboard";
+    static const std::string path = "/system/chassis/motherboard";
+
+    return path;
 }
 
 void Nisqually::addToInventory([[maybe_unused]] Inventory* inventory)
@@ -100,8 +116,23 @@ void Nisqually::removeFromInventory([[maybe_unused]] Inventory* inventory)
     throw std::logic_error("Unimplemented");
 }
 
-bool Nisqually::isFlettPresentAt(int slot)
+bool Nisqually::isFlettPresentAt(int slot, [[maybe_unused]] bool identify)
 {
+#if PLATFORM_EEPROM_IDENTIFICATION
+    /*
+     * Avoid waiting on the VPD parsers if the card's EEPROM is readable. The
+     * probe waits out the driver bind timeout on an empty slot, so callers
+     * only ask for it when a card may be there.
+     */
+    if (identify)
+    {
+        if (std::optional<bool> identified = Flett::isFlettAt(this, slot))
+        {
+            return identified.value();
+        }
+    }
+#endif
+
     std::string path = Flett::getInventoryPathFor(this, slot);
 
     bool populated = inventory->isPresent(path);
@@ -112,7 +143,7 @@ bool Nisqually::isFlettPresentAt(int slot)
         return false;
     }
 
-    bool validModel = inventory->isModel(path, "6B87");
+    bool validModel = inventory->isModel(path, Flett::ccin);
     if (!validModel)
     {
         debug(
@@ -131,33 +162,106 @@ void Nisqually::detectFlettCards(Notifier& notifier)
 {
     debug("Locating Flett cards");
 
-    /* FIXME: do something more ergonomic */
+    /*
+     * Subscribe before the initial lookup so a card identified while we're
+     * probing the others isn't missed
+     */
     for (const auto& [connector, slot] : flettConnectorSlotMap)
     {
+        watchFlettCard(notifier, connector, slot);
+    }
+
+    TaskGroup group;
+
+    /* FIXME: do something more ergonomic */
+    for (const auto& entry : flettConnectorSlotMap)
+    {
+        group.spawn([this, &notifier, connector = entry.first,
+                     slot = entry.second]() {
+            detectFlettCard(notifier, connector, slot, true);
+        });
+    }
+
+    group.wait();
+}
+
+void Nisqually::watchFlettCard(Notifier& notifier, int connector, int slot)
+{
+    std::string path = Flett::getInventoryPathFor(this, slot);
+
+    /*
+     * The slot's presence and the card's model may be published separately and
+     * in either order, so re-evaluate both whenever either changes
+     */
+    auto update = [this, &notifier, connector,
+                   slot](dbus::PropertiesChanged&& props) {
+        debug("Inventory updated for slot {PCIE_SLOT}, re-evaluating Flett",
+              "PCIE_SLOT", slot);
+
+        /*
+         * This runs on the event loop, so only probe the EEPROM if the update
+         * reports a card. Otherwise the inventory decides.
+         */
+        bool identify = props.findBool("Present").value_or(false);
+
+        /*
+         * Contain failures to this update: escaping the callback would drop
+         * the inventory's sink from the notifier, and with it every later
+         * update
+         */
         try
         {
-            if (isFlettPresentAt(slot))
-            {
-                flettConnectors[connector].populate(notifier);
-                debug("Initialised Flett {FLETT_ID} in slot {PCIE_SLOT}",
-                      "FLETT_ID", getFlettIndex(slot), "PCIE_SLOT", slot);
-            }
-            else
-            {
-                flettConnectors[connector].depopulate(notifier);
-            }
+            detectFlettCard(notifier, connector, slot, identify);
+        }
+        catch (const std::exception& ex)
+        {
+            warning(
+                "Failed to re-evaluate Flett in slot {PCIE_SLOT}: {EXCEPTION}",
+                "PCIE_SLOT", slot, "EXCEPTION", ex);
         }
-        catch (const SysfsI2CDeviceDriverBindException& ex)
+        catch (const std::error_condition& err)
         {
-            debug(
-                "Required drivers failed to bind for devices on Flett {FLETT_ID} in slot {PCIE_SLOT}: {EXCEPTION}",
-                "FLETT_ID", getFlettIndex(slot), "PCIE_SLOT", slot, "EXCEPTION",
-                ex);
-            warning("Failed to detect Flett in slot {PCIE_SLOT}", "PCIE_SLOT",
-                    slot);
-            continue;
+            warning(
+                "Failed to re-evaluate Flett in slot {PCIE_SLOT}: {ERROR_DESCRIPTION}",
+                "PCIE_SLOT", slot, "ERROR_DESCRIPTION", err.message(), "ERROR",
+                err.value());
+        }
+    };
+
+    for (const auto* interface :
+         {inventory::INVENTORY_ITEM_IFACE,
+          inventory::INVENTORY_DECORATOR_ASSET_IFACE})
+    {
+        flettListeners.push_back(
+            inventory->addPropertiesChangedListener(path, interface, update));
+    }
+}
+
+void Nisqually::detectFlettCard(Notifier& notifier, int connector, int slot,
+                                bool identify)
+{
+    try
+    {
+        if (isFlettPresentAt(slot, identify))
+        {
+            flettConnectors.at(connector).populate(notifier);
+            debug("Initialised Flett {FLETT_ID} in slot {PCIE_SLOT}",
+                  "FLETT_ID", getFlettIndex(slot), "PCIE_SLOT", slot);
+        }
+        else
+        {
+            flettConnectors.at(connector).depopulate(notifier);
         }
     }
+    catch (const SysfsI2CDeviceDriverBindException& ex)
+    {
+        debug(
+            "Required drivers failed to bind for devices on Flett {FLETT_ID} in slot {PCIE_SLOT}: {EXCEPTION}",
+            "FLETT_ID", getFlettIndex(slot), "PCIE_SLOT", slot, "EXCEPTION",
+            ex);
+        warning("Failed to detect Flett in slot {PCIE_SLOT}", "PCIE_SLOT",
+                slot);
+    }
 }
 
 void Nisqually::detectWilliwakasCards(Notifier& notifier)
@@ -166,48 +270,25 @@ void Nisqually::detectWilliwakasCards(Notifier& notifier)
 
     std::filesystem::path path(Nisqually::williwakasPresenceDevicePath);
     SysfsGPIOChip sysfsChip(path);
-    gpiod::chip williwakasPresenceChip(sysfsChip.getName().string(),
-                                       gpiod::chip::OPEN_BY_NAME);
-
-    for (unsigned long index :
-         std::views::iota(0UL, Nisqually::williwakasPresenceMap.size()))
+    gpiod::chip williwakasPresenceChip(sysfsChip.getDevice().string(),
+                                       gpiod::chip::OPEN_BY_PATH);
+
+    /*
+     * Keep the presence lines and poll them so backplanes that are reseated or
+     * cabled after startup are plugged and unplugged individually
+     */
+    for (std::size_t index = 0; index < williwakasPresenceMap.size(); index++)
     {
         int offset = Nisqually::williwakasPresenceMap.at(index);
         gpiod::line line = williwakasPresenceChip.get_line(offset);
         line.request({program_invocation_short_name,
                       gpiod::line::DIRECTION_INPUT, gpiod::line::ACTIVE_LOW});
 
-        bool present = line.get_value() != 0;
-
-        line.release();
-
-        debug(
-            "Williwakas presence at index {WILLIWAKAS_ID}: {WILLIWAKAS_PRESENT}",
-            "WILLIWAKAS_ID", index, "WILLIWAKAS_PRESENT", present);
-
-        try
-        {
-            if (present)
-            {
-                williwakasConnectors[index].populate(notifier);
-                info("Initialised Williwakas {WILLIWAKAS_ID}", "WILLIWAKAS_ID",
-                     index);
-            }
-            else
-            {
-                williwakasConnectors[index].depopulate(notifier);
-            }
-        }
-        catch (const SysfsI2CDeviceDriverBindException& ex)
-        {
-            std::string what(ex.what());
-            error(
-                "Required drivers failed to bind for devices on Williwakas {WILLIWAKAS_ID}: {EXCEPTION_DESCRIPTION}",
-                "WILLIWAKAS_ID", index, "EXCEPTION_DESCRIPTION", what);
-            warning("Skipping FRU detection on Williwakas {WILLIWAKAS_ID}",
-                    "WILLIWAKAS_ID", index);
-        }
+        williwakasConnectors.start(notifier, index,
+                                   GpioLinePresence(std::move(line)));
     }
+
+    williwakasConnectors.sample(notifier);
 }
 
 /* Nisqually0z */
@@ -226,24 +307,33 @@ Nisqually1z::Nisqually1z(Inventory* inventory) : Nisqually(inventory) {}
 SysfsI2CBus Nisqually1z::getFlettSlotI2CBus(int slot) const
 {
     SysfsI2CBus rootBus = Ingraham::getPCIeSlotI2CBus(slot);
-    SysfsI2CMux mux(rootBus, Nisqually1z::slotMuxAddress);
 
     debug("Looking up mux channel for Flett in slot {PCIE_SLOT}", "PCIE_SLOT",
           slot);
 
     int channel = flettMuxChannelMap.at(slot);
 
-    return {mux, channel};
+    return SysfsI2CTopology::instance().getMuxChannel(
+        rootBus, Nisqually1z::slotMuxAddress, channel);
 }
 
 void Nisqually1z::plug(Notifier& notifier)
 {
+    /* The slot muxes must exist before we can probe the Flett cards */
+    TaskGroup group;
+
     /* Slot 9 is on the same mux as slot 8 */
-    Ingraham::getPCIeSlotI2CBus(8).probeDevice("pca9546",
-                                               Nisqually1z::slotMuxAddress);
+    group.spawn([]() {
+        Ingraham::getPCIeSlotI2CBus(8).probeDevice("pca9546",
+                                                   Nisqually1z::slotMuxAddress);
+    });
     /* Slot 11 is on the same mux as slot 10 */
-    Ingraham::getPCIeSlotI2CBus(10).probeDevice("pca9546",
-                                                Nisqually1z::slotMuxAddress);
+    group.spawn([]() {
+        Ingraham::getPCIeSlotI2CBus(10).probeDevice(
+            "pca9546", Nisqually1z::slotMuxAddress);
+    });
+
+    group.wait();
 
     Nisqually::plug(notifier);
 }
@@ -252,6 +342,11 @@ void Nisqually1z::unplug(Notifier& notifier, int mode)
 {
     Nisqually::unplug(notifier, mode);
 
+    if (mode == Device::UNPLUG_RETAINS_DEVICES)
+    {
+        return;
+    }
+
     try
     {
         Ingraham::getPCIeSlotI2CBus(8).removeDevice(
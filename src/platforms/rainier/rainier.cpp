@@ -5,6 +5,7 @@
 
 #include "inventory.hpp"
 #include "inventory/migrations.hpp"
+#include "tasks.hpp"
 
 void Rainier0z::enrollWith(PlatformManager& pm)
 {
@@ -19,20 +20,39 @@ void Rainier0z::enrollWith(PlatformManager& pm)
 void Rainier0z::detectFrus(Notifier& notifier, Inventory* inventory)
 {
     PublishWhenPresentInventoryDecorator decoratedInventory(inventory);
-    Nisqually0z nisqually(&decoratedInventory);
+    SynchronisedInventoryDecorator synchronisedInventory(&decoratedInventory);
+    Nisqually0z nisqually(&synchronisedInventory);
     Ingraham ingraham(&nisqually);
 
-    Inventory::migrate(inventory, inventory::MigrateNVMeIPZVPDFromSlotToDrive(),
-                       inventory::MigrateNVMeI2CEndpointFromSlotToDrive());
+    /*
+     * Cold-plug devices, probing independent buses concurrently. The
+     * migrations run alongside, and the inventory is held until they're done.
+     */
+    synchronisedInventory.hold();
+    {
+        StartupReport::Phase phase =
+            notifier.startupPhase("Cold-plugging devices");
+        WorkPool pool;
+        TaskGroup group;
 
-    /* Cold-plug devices */
-    ingraham.plug(notifier);
+        group.spawn([&synchronisedInventory, &notifier]() {
+            StartupReport::Phase phase =
+                notifier.startupPhase("Migrating inventory");
+            Inventory::migrate(
+                &synchronisedInventory,
+                inventory::MigrateNVMeIPZVPDFromSlotToDrive(),
+                inventory::MigrateNVMeI2CEndpointFromSlotToDrive());
+        });
+        group.spawn([&ingraham, &notifier]() { ingraham.plug(notifier); });
+
+        group.wait();
+    }
 
     /* Hot-plug devices */
     notifier.run();
 
     /* Clean up the application state but leave the inventory in-tact. */
-    ingraham.unplug(notifier, Ingraham::UNPLUG_RETAINS_INVENTORY);
+    ingraham.unplug(notifier, unplugModeForExit(notifier));
 }
 
 void Rainier1z::enrollWith(PlatformManager& pm)
@@ -48,18 +68,37 @@ void Rainier1z::enrollWith(PlatformManager& pm)
 void Rainier1z::detectFrus(Notifier& notifier, Inventory* inventory)
 {
     PublishWhenPresentInventoryDecorator decoratedInventory(inventory);
-    Nisqually1z nisqually(&decoratedInventory);
+    SynchronisedInventoryDecorator synchronisedInventory(&decoratedInventory);
+    Nisqually1z nisqually(&synchronisedInventory);
     Ingraham ingraham(&nisqually);
 
-    Inventory::migrate(inventory, inventory::MigrateNVMeIPZVPDFromSlotToDrive(),
-                       inventory::MigrateNVMeI2CEndpointFromSlotToDrive());
+    /*
+     * Cold-plug devices, probing independent buses concurrently. The
+     * migrations run alongside, and the inventory is held until they're done.
+     */
+    synchronisedInventory.hold();
+    {
+        StartupReport::Phase phase =
+            notifier.startupPhase("Cold-plugging devices");
+        WorkPool pool;
+        TaskGroup group;
+
+        group.spawn([&synchronisedInventory, &notifier]() {
+            StartupReport::Phase phase =
+                notifier.startupPhase("Migrating inventory");
+            Inventory::migrate(
+                &synchronisedInventory,
+                inventory::MigrateNVMeIPZVPDFromSlotToDrive(),
+                inventory::MigrateNVMeI2CEndpointFromSlotToDrive());
+        });
+        group.spawn([&ingraham, &notifier]() { ingraham.plug(notifier); });
 
-    /* Cold-plug devices */
-    ingraham.plug(notifier);
+        group.wait();
+    }
 
     /* Hot-plug devices */
     notifier.run();
 
     /* Clean up the application state but leave the inventory in-tact. */
-    ingraham.unplug(notifier, Ingraham::UNPLUG_RETAINS_INVENTORY);
+    ingraham.unplug(notifier, unplugModeForExit(notifier));
 }
@@ -0,0 +1,231 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "polling.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <charconv>
+#include <fstream>
+
+PHOSPHOR_LOG2_USING;
+
+using std::chrono::milliseconds;
+
+PollPolicies& PollPolicies::instance()
+{
+    static PollPolicies policies;
+
+    return policies;
+}
+
+PollPolicies::PollPolicies() : busBudget(defaultBusBudget)
+{
+    /*
+     * Presence of drives and backplanes rarely changes, so back off from the
+     * one second interval while it's stable
+     */
+    set(defaultClass, {milliseconds(1000), milliseconds(1000)});
+    set("drive", {milliseconds(1000), milliseconds(4000)});
+    set("backplane", {milliseconds(1000), milliseconds(8000)});
+}
+
+static bool parseCount(std::string_view field, unsigned int& value)
+{
+    const char* end = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), end, value);
+
+    return ec == std::errc() && ptr == end && !field.empty();
+}
+
+static bool parseMilliseconds(std::string_view field, milliseconds& value)
+{
+    unsigned int count = 0;
+
+    if (!parseCount(field, count) || count == 0)
+    {
+        return false;
+    }
+
+    value = milliseconds(count);
+
+    return true;
+}
+
+static std::string_view nextField(std::string_view& line)
+{
+    std::size_t begin = line.find_first_not_of(" \t");
+    if (begin == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+
+    line.remove_prefix(begin);
+    std::size_t end = line.find_first_of(" \t");
+    std::string_view field = line.substr(0, end);
+    line.remove_prefix(end == std::string_view::npos ? line.size() : end);
+
+    return field;
+}
+
+bool PollPolicies::load(const std::filesystem::path& path)
+{
+    std::ifstream config(path);
+
+    if (!config.is_open())
+    {
+        debug("No poll policies at '{POLL_CONFIG_PATH}', using defaults",
+              "POLL_CONFIG_PATH", path.string());
+        return true;
+    }
+
+    return load(config);
+}
+
+bool PollPolicies::load(std::istream& config)
+{
+    std::string line;
+    int number = 0;
+    bool valid = true;
+
+    while (std::getline(config, line))
+    {
+        number++;
+
+        std::string_view remaining(line);
+        remaining = remaining.substr(0, remaining.find('#'));
+
+        std::string_view name = nextField(remaining);
+        if (name.empty())
+        {
+            continue;
+        }
+
+        if (name == "bus-budget")
+        {
+            unsigned int budget = 0;
+            if (!parseCount(nextField(remaining), budget) ||
+                !nextField(remaining).empty())
+            {
+                warning(
+                    "Ignoring malformed bus budget on line {POLL_CONFIG_LINE}",
+                    "POLL_CONFIG_LINE", number);
+                valid = false;
+                continue;
+            }
+
+            setBusBudget(budget);
+            continue;
+        }
+
+        PollPolicy policy{};
+        if (!parseMilliseconds(nextField(remaining), policy.interval) ||
+            !parseMilliseconds(nextField(remaining), policy.latency) ||
+            !nextField(remaining).empty() || policy.latency < policy.interval)
+        {
+            warning("Ignoring malformed poll policy on line {POLL_CONFIG_LINE}",
+                    "POLL_CONFIG_LINE", number);
+            valid = false;
+            continue;
+        }
+
+        set(name, policy);
+    }
+
+    return valid;
+}
+
+void PollPolicies::set(std::string_view pollClass, const PollPolicy& policy)
+{
+    policies.insert_or_assign(std::string(pollClass), policy);
+}
+
+PollPolicy PollPolicies::get(std::string_view pollClass) const
+{
+    auto found = policies.find(pollClass);
+    if (found == policies.end())
+    {
+        found = policies.find(defaultClass);
+    }
+
+    return found == policies.end() ? PollPolicy{} : found->second;
+}
+
+void PollPolicies::setBusBudget(unsigned int budget)
+{
+    busBudget = budget;
+}
+
+unsigned int PollPolicies::getBusBudget() const
+{
+    return busBudget;
+}
+
+ProbeScheduler& ProbeScheduler::instance()
+{
+    static ProbeScheduler scheduler;
+
+    return scheduler;
+}
+
+ProbeScheduler::ProbeScheduler(const PollPolicies& policies) :
+    policies(policies)
+{}
+
+double ProbeScheduler::assignPhase(int adapter)
+{
+    std::scoped_lock guard(lock);
+    unsigned int sequence = ++adapters[adapter].pollers;
+
+    /* The base-2 van der Corput sequence: mirror the bits about the point */
+    double phase = 0.0;
+    for (double place = 0.5; sequence != 0; place /= 2, sequence >>= 1)
+    {
+        if ((sequence & 1) != 0)
+        {
+            phase += place;
+        }
+    }
+
+    return phase;
+}
+
+void ProbeScheduler::releasePhase(int adapter)
+{
+    std::scoped_lock guard(lock);
+    auto found = adapters.find(adapter);
+
+    if (found != adapters.end() && found->second.pollers > 0)
+    {
+        found->second.pollers--;
+    }
+}
+
+bool ProbeScheduler::tryAcquire(int adapter,
+                                std::chrono::steady_clock::time_point now)
+{
+    const unsigned int budget = policies.getBusBudget();
+
+    if (budget == 0 || adapter == noAdapter)
+    {
+        return true;
+    }
+
+    std::scoped_lock guard(lock);
+    Adapter& state = adapters[adapter];
+
+    if (now - state.window >= std::chrono::seconds(1))
+    {
+        state.window = now;
+        state.used = 0;
+    }
+
+    if (state.used >= budget)
+    {
+        return false;
+    }
+
+    state.used++;
+
+    return true;
+}
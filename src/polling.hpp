@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/*
+ * How often a class of connectors is polled. A poller uses the interval
+ * while presence is changing, after a rescan, or just after it has started.
+ * It then backs off while presence is stable, but never beyond the latency,
+ * which bounds how long a change can go unnoticed.
+ */
+struct PollPolicy
+{
+    std::chrono::milliseconds interval{1000};
+    std::chrono::milliseconds latency{1000};
+};
+
+/*
+ * The policies for each class of connector, keyed by the 'pollClass' name a
+ * device class declares. Classes without a policy use the "default" policy.
+ *
+ * Policies are read from a file with a line per class:
+ *
+ *     # class interval-ms latency-ms
+ *     drive 500 4000
+ *
+ * The file may also set the number of probe transactions each physical I2C
+ * adapter may carry per second, where 0 lifts the limit:
+ *
+ *     bus-budget 32
+ *
+ * Load the policies before cold-plug; lookups aren't synchronised with
+ * updates.
+ */
+class PollPolicies
+{
+  public:
+    static constexpr const char* defaultPath =
+        "/etc/platform-fru-detect/polling.conf";
+    static constexpr const char* defaultClass = "default";
+    static constexpr unsigned int defaultBusBudget = 32;
+
+    static PollPolicies& instance();
+
+    PollPolicies();
+    PollPolicies(const PollPolicies& other) = delete;
+    PollPolicies(PollPolicies&& other) = delete;
+    ~PollPolicies() = default;
+
+    PollPolicies& operator=(const PollPolicies& other) = delete;
+    PollPolicies& operator=(PollPolicies&& other) = delete;
+
+    /* Returns false if the file exists but couldn't be parsed in full */
+    bool load(const std::filesystem::path& path);
+    bool load(std::istream& config);
+
+    void set(std::string_view pollClass, const PollPolicy& policy);
+    PollPolicy get(std::string_view pollClass) const;
+
+    void setBusBudget(unsigned int budget);
+    unsigned int getBusBudget() const;
+
+  private:
+    std::map<std::string, PollPolicy, std::less<>> policies;
+    unsigned int busBudget;
+};
+
+/* Device classes may declare 'static constexpr const char* pollClass' */
+template <typename T>
+constexpr const char* pollClassFor()
+{
+    if constexpr (requires { T::pollClass; })
+    {
+        return T::pollClass;
+    }
+    else
+    {
+        return PollPolicies::defaultClass;
+    }
+}
+
+/*
+ * Spreads polling across time so pollers sharing a physical I2C adapter don't
+ * probe it in bursts.
+ *
+ * Each poller on an adapter is assigned a phase, the fraction of its interval
+ * after which it first expires. Successive phases subdivide the interval
+ * (1/2, 1/4, 3/4, 1/8, ...) so they stay evenly spread however many pollers
+ * arrive. Each adapter also has a budget of probe transactions per second;
+ * probes beyond it are deferred to a later tick.
+ */
+class ProbeScheduler
+{
+  public:
+    /* For pollers that don't probe an I2C adapter */
+    static constexpr int noAdapter = -1;
+
+    static ProbeScheduler& instance();
+
+    explicit ProbeScheduler(
+        const PollPolicies& policies = PollPolicies::instance());
+    ProbeScheduler(const ProbeScheduler& other) = delete;
+    ProbeScheduler(ProbeScheduler&& other) = delete;
+    ~ProbeScheduler() = default;
+
+    ProbeScheduler& operator=(const ProbeScheduler& other) = delete;
+    ProbeScheduler& operator=(ProbeScheduler&& other) = delete;
+
+    /* Returns a phase in (0, 1) for the next poller on the adapter */
+    double assignPhase(int adapter);
+    /* Returns a poller's phase when it's disarmed, so churn doesn't accrue */
+    void releasePhase(int adapter);
+
+    /* Returns false if the adapter's budget for the current second is spent */
+    bool tryAcquire(int adapter, std::chrono::steady_clock::time_point now =
+                                     std::chrono::steady_clock::now());
+
+  private:
+    struct Adapter
+    {
+        unsigned int pollers = 0;
+        unsigned int used = 0;
+        std::chrono::steady_clock::time_point window{};
+    };
+
+    const PollPolicies& policies;
+    std::mutex lock;
+    std::map<int, Adapter> adapters;
+};
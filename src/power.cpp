@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "power.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/bus.hpp>
+
+#include <variant>
+
+PHOSPHOR_LOG2_USING;
+
+static constexpr const char* chassisStateBusName =
+    "xyz.openbmc_project.State.Chassis";
+static constexpr const char* chassisStateIface =
+    "xyz.openbmc_project.State.Chassis";
+static constexpr const char* powerStateOn =
+    "xyz.openbmc_project.State.Chassis.PowerState.On";
+
+HostPowerMonitor::HostPowerMonitor(sdbusplus::bus::bus& dbus,
+                                   Notifier& notifier) :
+    dbus(dbus), notifier(notifier)
+{
+    /* Subscribe before the initial read so no transition is missed */
+    listener = dbus::sharedPropertiesChangedListener(
+        dbus, chassisPath, chassisStateIface,
+        [this]([[maybe_unused]] dbus::PropertiesChanged&& props) {
+            update();
+        });
+
+    update();
+}
+
+void HostPowerMonitor::update()
+{
+    auto call = dbus.new_method_call(chassisStateBusName, chassisPath,
+                                     "org.freedesktop.DBus.Properties", "Get");
+
+    call.append(chassisStateIface, "CurrentPowerState");
+
+    try
+    {
+        std::variant<std::string> state;
+        auto reply = dbus.call(call);
+        reply.read(state);
+
+        bool on = std::get<std::string>(state) == powerStateOn;
+        if (HostPower::instance().set(on))
+        {
+            info("Host power is {HOST_POWER_STATE}, {ACTION} endpoint probes",
+                 "HOST_POWER_STATE", on ? "on" : "off", "ACTION",
+                 on ? "resuming" : "suspending");
+
+            if (on)
+            {
+                notifier.rescan();
+            }
+        }
+    }
+    catch (const sdbusplus::exception::exception& ex)
+    {
+        /* Assume the host is powered and keep probing */
+        debug("Failed to read the chassis power state: {EXCEPTION}",
+              "EXCEPTION", ex);
+        HostPower::instance().set(true);
+    }
+}
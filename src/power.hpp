@@ -0,0 +1,76 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include "dbus.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+/*
+ * Tracks whether the host is powered so pollers can skip probing endpoints
+ * that are only powered with the host, such as the NVMe basic management
+ * endpoint. The host is assumed to be powered until told otherwise, so
+ * probing is unaffected if the power state can't be determined.
+ */
+class HostPower
+{
+  public:
+    static HostPower& instance()
+    {
+        static HostPower power;
+
+        return power;
+    }
+
+    HostPower() = default;
+    HostPower(const HostPower& other) = delete;
+    HostPower(HostPower&& other) = delete;
+    ~HostPower() = default;
+
+    HostPower& operator=(const HostPower& other) = delete;
+    HostPower& operator=(HostPower&& other) = delete;
+
+    bool isOn() const
+    {
+        return on.load(std::memory_order_relaxed);
+    }
+
+    /* Returns true if the state changed */
+    bool set(bool state)
+    {
+        return on.exchange(state, std::memory_order_relaxed) != state;
+    }
+
+  private:
+    std::atomic<bool> on = true;
+};
+
+/*
+ * Follows the chassis power state on D-Bus into HostPower::instance(), and
+ * rescans the notifier's pollers when power returns so endpoints are found
+ * promptly.
+ */
+class HostPowerMonitor
+{
+  public:
+    static constexpr const char* chassisPath =
+        "/xyz/openbmc_project/state/chassis0";
+
+    HostPowerMonitor() = delete;
+    HostPowerMonitor(sdbusplus::bus::bus& dbus, Notifier& notifier);
+    HostPowerMonitor(const HostPowerMonitor& other) = delete;
+    HostPowerMonitor(HostPowerMonitor&& other) = delete;
+    ~HostPowerMonitor() = default;
+
+    HostPowerMonitor& operator=(const HostPowerMonitor& other) = delete;
+    HostPowerMonitor& operator=(HostPowerMonitor&& other) = delete;
+
+  private:
+    void update();
+
+    sdbusplus::bus::bus& dbus;
+    Notifier& notifier;
+    std::shared_ptr<dbus::PropertiesChangedListener> listener;
+};
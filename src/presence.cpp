@@ -0,0 +1,358 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+
+#include "presence.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <system_error>
+
+PHOSPHOR_LOG2_USING;
+
+using namespace presence;
+
+bool PresenceTable::read(const Layout* table, Snapshot& out)
+{
+    if (table->magic != tableMagic || table->version != tableVersion)
+    {
+        return false;
+    }
+
+    uint32_t before = 0;
+    uint32_t after = 0;
+
+    do
+    {
+        before = table->sequence.load(std::memory_order_acquire);
+        if ((before & 1U) != 0U)
+        {
+            continue;
+        }
+
+        for (std::size_t i = 0; i < out.size(); i++)
+        {
+            const Entry& entry = table->entries.at(i);
+
+            out.at(i) = {
+                entry.state.load(std::memory_order_relaxed),
+                entry.transitions.load(std::memory_order_relaxed),
+                entry.seconds.load(std::memory_order_relaxed),
+                entry.nanoseconds.load(std::memory_order_relaxed),
+                entry.flaps.load(std::memory_order_relaxed),
+                entry.fingerprint.load(std::memory_order_relaxed),
+            };
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = table->sequence.load(std::memory_order_relaxed);
+    } while ((before & 1U) != 0U || before != after);
+
+    return true;
+}
+
+BootID PresenceTable::currentBootID()
+{
+    static constexpr const char* bootIDPath =
+        "/proc/sys/kernel/random/boot_id";
+
+    BootID id{};
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    int fd = ::open(bootIDPath, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        warning("Failed to open boot ID: {ERRNO_DESCRIPTION}",
+                "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO", errno);
+        return id;
+    }
+
+    /* A UUID in its canonical textual form, e.g. 8-4-4-4-12 hex digits */
+    std::array<char, 36> text{};
+    ssize_t rc = ::read(fd, text.data(), text.size());
+    ::close(fd);
+    if (rc != static_cast<ssize_t>(text.size()))
+    {
+        warning("Failed to read boot ID");
+        return id;
+    }
+
+    std::size_t digits = 0;
+    for (char c : text)
+    {
+        if (c == '-')
+        {
+            continue;
+        }
+
+        uint8_t nibble = 0;
+        if (c >= '0' && c <= '9')
+        {
+            nibble = static_cast<uint8_t>(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            nibble = static_cast<uint8_t>(c - 'a' + 10);
+        }
+        else
+        {
+            warning("Malformed boot ID");
+            return {};
+        }
+
+        if (digits / 2 >= id.size())
+        {
+            warning("Malformed boot ID");
+            return {};
+        }
+
+        id.at(digits / 2) |= (digits % 2 == 0) ? (nibble << 4U) : nibble;
+        digits++;
+    }
+
+    return id;
+}
+
+PresenceTable::PresenceTable(const std::filesystem::path& path,
+                             const BootID& bootID) :
+    restored(false)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec)
+    {
+        error("Failed to create directory for presence table '{PATH}': {ERROR}",
+              "PATH", path.parent_path(), "ERROR", ec.message());
+        throw std::system_category().default_error_condition(ec.value());
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+        error("Failed to open presence table '{PATH}': {ERRNO_DESCRIPTION}",
+              "PATH", path, "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO",
+              errno);
+        throw std::system_category().default_error_condition(errno);
+    }
+
+    int rc = ::ftruncate(fd, sizeof(Layout));
+    if (rc == -1)
+    {
+        int err = errno;
+        ::close(fd);
+        error("Failed to size presence table '{PATH}': {ERRNO_DESCRIPTION}",
+              "PATH", path, "ERRNO_DESCRIPTION", ::strerror(err), "ERRNO",
+              err);
+        throw std::system_category().default_error_condition(err);
+    }
+
+    void* region = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0);
+    int err = errno;
+    /* The mapping holds a reference to the file */
+    ::close(fd);
+    if (region == MAP_FAILED)
+    {
+        error("Failed to map presence table '{PATH}': {ERRNO_DESCRIPTION}",
+              "PATH", path, "ERRNO_DESCRIPTION", ::strerror(err), "ERRNO",
+              err);
+        throw std::system_category().default_error_condition(err);
+    }
+
+    table = static_cast<Layout*>(region);
+
+    /*
+     * Keep the state published by a previous instance of the daemon in this
+     * boot. It reflects what that instance applied to the inventory, which
+     * persists across the restart. An unknown boot ID never matches.
+     *
+     * An odd sequence number means the previous instance died mid-update.
+     * The entry it was writing may be torn, and continuing from an odd base
+     * would invert the seqlock's parity for good, so reset the table.
+     */
+    if (table->magic == tableMagic && table->version == tableVersion &&
+        table->capacity == tableCapacity && table->bootID == bootID &&
+        bootID != BootID{} &&
+        (table->sequence.load(std::memory_order_relaxed) & 1U) == 0U)
+    {
+        restored = true;
+        info("Restored connector presence from '{PATH}'", "PATH", path);
+        return;
+    }
+
+    /*
+     * Invalidate the table while we reset it so readers don't consume the
+     * state published by a previous instance of the daemon.
+     */
+    table->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    table->version = tableVersion;
+    table->capacity = tableCapacity;
+    table->bootID = bootID;
+    table->sequence.store(0, std::memory_order_relaxed);
+    for (auto& entry : table->entries)
+    {
+        entry.state.store(STATE_UNKNOWN, std::memory_order_relaxed);
+        entry.transitions.store(0, std::memory_order_relaxed);
+        entry.seconds.store(0, std::memory_order_relaxed);
+        entry.nanoseconds.store(0, std::memory_order_relaxed);
+        entry.flaps.store(0, std::memory_order_relaxed);
+        entry.fingerprint.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    table->magic = tableMagic;
+
+    debug("Publishing connector presence to '{PATH}'", "PATH", path);
+}
+
+PresenceTable::~PresenceTable()
+{
+    int rc = ::munmap(table, sizeof(Layout));
+    if (rc == -1)
+    {
+        warning("Failed to unmap presence table: {ERRNO_DESCRIPTION}",
+                "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO", errno);
+    }
+}
+
+PresenceBitmap<tableCapacity> PresenceTable::restoredAbsent() const
+{
+    PresenceBitmap<tableCapacity> absent;
+
+    if (!restored)
+    {
+        return absent;
+    }
+
+    for (std::size_t id = 0; id < tableCapacity; id++)
+    {
+        const Entry& entry = table->entries.at(id);
+
+        absent.set(id, entry.state.load(std::memory_order_relaxed) ==
+                           STATE_ABSENT);
+    }
+
+    return absent;
+}
+
+PresenceBitmap<tableCapacity> PresenceTable::restoredPresent() const
+{
+    PresenceBitmap<tableCapacity> present;
+
+    if (!restored)
+    {
+        return present;
+    }
+
+    for (std::size_t id = 0; id < tableCapacity; id++)
+    {
+        const Entry& entry = table->entries.at(id);
+
+        present.set(id, entry.state.load(std::memory_order_relaxed) ==
+                            STATE_PRESENT);
+    }
+
+    return present;
+}
+
+Fingerprints PresenceTable::restoredFingerprints() const
+{
+    Fingerprints fingerprints{};
+
+    if (!restored)
+    {
+        return fingerprints;
+    }
+
+    for (std::size_t id = 0; id < tableCapacity; id++)
+    {
+        fingerprints.at(id) =
+            table->entries.at(id).fingerprint.load(std::memory_order_relaxed);
+    }
+
+    return fingerprints;
+}
+
+void PresenceTable::presenceChanged(ConnectorID id, bool present)
+{
+    if (id >= tableCapacity)
+    {
+        warning("Connector ID {CONNECTOR_ID} exceeds presence table capacity",
+                "CONNECTOR_ID", id);
+        return;
+    }
+
+    Entry& entry = table->entries.at(id);
+    const uint32_t state = present ? STATE_PRESENT : STATE_ABSENT;
+
+    /* Re-publishing the current state, e.g. on adoption, isn't a transition */
+    if (entry.state.load(std::memory_order_relaxed) == state)
+    {
+        return;
+    }
+
+    struct timespec now{};
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+    uint32_t sequence = table->sequence.load(std::memory_order_relaxed);
+
+    table->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    entry.state.store(state, std::memory_order_relaxed);
+    if (!present)
+    {
+        entry.fingerprint.store(0, std::memory_order_relaxed);
+    }
+    entry.transitions.fetch_add(1, std::memory_order_relaxed);
+    entry.seconds.store(static_cast<uint32_t>(now.tv_sec),
+                        std::memory_order_relaxed);
+    entry.nanoseconds.store(static_cast<uint32_t>(now.tv_nsec),
+                            std::memory_order_relaxed);
+
+    table->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void PresenceTable::presenceFlapped(ConnectorID id)
+{
+    if (id >= tableCapacity)
+    {
+        return;
+    }
+
+    uint32_t sequence = table->sequence.load(std::memory_order_relaxed);
+
+    table->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    table->entries.at(id).flaps.fetch_add(1, std::memory_order_relaxed);
+
+    table->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void PresenceTable::presenceIdentified(ConnectorID id, uint32_t fingerprint)
+{
+    if (id >= tableCapacity)
+    {
+        return;
+    }
+
+    uint32_t sequence = table->sequence.load(std::memory_order_relaxed);
+
+    table->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    table->entries.at(id).fingerprint.store(fingerprint,
+                                            std::memory_order_relaxed);
+
+    table->sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,445 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+/*
+ * Connector IDs are stable across restarts of the daemon: they're derived from
+ * the position of the connector in the platform topology and not from the order
+ * in which the connectors are probed. Each platform documents its layout
+ * alongside the devices that own the connectors.
+ */
+using ConnectorID = uint16_t;
+
+/*
+ * Presence of a group of connectors packed one bit per connector. The
+ * connectors that changed between two samples are found by walking the set
+ * bits of the XOR of the samples, so the cost of a scan in which nothing
+ * changed is independent of the number of connectors.
+ */
+template <std::size_t N>
+class PresenceBitmap
+{
+  public:
+    bool test(std::size_t index) const
+    {
+        return (words.at(index / wordBits) & mask(index)) != 0;
+    }
+
+    void set(std::size_t index, bool present = true)
+    {
+        Word& word = words.at(index / wordBits);
+
+        word = present ? (word | mask(index)) : (word & ~mask(index));
+    }
+
+    void reset(std::size_t index)
+    {
+        set(index, false);
+    }
+
+    void clear()
+    {
+        words.fill(0);
+    }
+
+    bool any() const
+    {
+        for (const Word word : words)
+        {
+            if (word != 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::size_t count() const
+    {
+        std::size_t total = 0;
+
+        for (const Word word : words)
+        {
+            total += std::popcount(word);
+        }
+
+        return total;
+    }
+
+    /* Invoke f with the index of each set bit in ascending order */
+    template <typename F>
+    void forEach(F&& f) const
+    {
+        for (std::size_t i = 0; i < words.size(); i++)
+        {
+            Word remaining = words.at(i);
+
+            while (remaining != 0)
+            {
+                f(i * wordBits + std::countr_zero(remaining));
+                remaining &= remaining - 1;
+            }
+        }
+    }
+
+    PresenceBitmap operator^(const PresenceBitmap& other) const
+    {
+        return combine(other, [](Word a, Word b) { return a ^ b; });
+    }
+
+    PresenceBitmap operator|(const PresenceBitmap& other) const
+    {
+        return combine(other, [](Word a, Word b) { return a | b; });
+    }
+
+    PresenceBitmap operator&(const PresenceBitmap& other) const
+    {
+        return combine(other, [](Word a, Word b) { return a & b; });
+    }
+
+    bool operator==(const PresenceBitmap& other) const = default;
+
+  private:
+    using Word = uint64_t;
+
+    static constexpr std::size_t wordBits = 64;
+
+    static constexpr Word mask(std::size_t index)
+    {
+        return Word{1} << (index % wordBits);
+    }
+
+    template <typename Op>
+    PresenceBitmap combine(const PresenceBitmap& other, Op op) const
+    {
+        PresenceBitmap result;
+
+        for (std::size_t i = 0; i < words.size(); i++)
+        {
+            result.words.at(i) = op(words.at(i), other.words.at(i));
+        }
+
+        return result;
+    }
+
+    std::array<Word, (N + wordBits - 1) / wordBits> words{};
+};
+
+/*
+ * The number of consecutive samples that must agree before a connector's
+ * debounced presence follows its probe. Insertion and removal are counted
+ * separately so a device can be unplugged more reluctantly than it's plugged.
+ */
+struct DebouncePolicy
+{
+    uint8_t insertion = 1;
+    uint8_t removal = 1;
+};
+
+/* Device classes may declare 'static constexpr DebouncePolicy debounce' */
+template <typename T>
+constexpr DebouncePolicy debouncePolicyFor()
+{
+    if constexpr (requires { T::debounce; })
+    {
+        return T::debounce;
+    }
+    else
+    {
+        return DebouncePolicy{};
+    }
+}
+
+/*
+ * The presence state of a group of connectors:
+ *
+ * - observed: The most recent sample from each connector's probe
+ * - debounced: The presence the connectors are driven towards
+ * - published: The presence last applied to each connector
+ * - unsettled: Connectors that must be visited on the next scan regardless of
+ *   their published state, e.g. because they were just started
+ * - settling: Connectors whose observed presence disagrees with the debounced
+ *   presence, for streaks[index] consecutive samples
+ *
+ * flaps[index] counts the disagreements that cleared before they were
+ * accepted, which identifies marginal seating or noisy presence lines.
+ */
+template <std::size_t N>
+struct PresenceModel
+{
+    PresenceBitmap<N> observed;
+    PresenceBitmap<N> debounced;
+    PresenceBitmap<N> published;
+    PresenceBitmap<N> unsettled;
+    PresenceBitmap<N> settling;
+    std::array<uint8_t, N> streaks{};
+    std::array<uint32_t, N> flaps{};
+
+    /* The connectors to populate or depopulate */
+    PresenceBitmap<N> pending() const
+    {
+        return (debounced ^ published) | unsettled;
+    }
+
+    /*
+     * Drive the debounced presence of the sampled connectors towards their
+     * observed presence. Unsettled connectors adopt what was observed
+     * immediately as there's no published state to protect.
+     *
+     * Returns the connectors that flapped in this sample.
+     */
+    PresenceBitmap<N> debounce(const PresenceBitmap<N>& sampled,
+                               const DebouncePolicy& policy)
+    {
+        const PresenceBitmap<N> differs = (observed ^ debounced) & sampled;
+        const PresenceBitmap<N> candidates = settling & sampled;
+        const PresenceBitmap<N> recovered = candidates ^ (candidates & differs);
+
+        recovered.forEach([this](std::size_t index) {
+            flaps.at(index)++;
+            streaks.at(index) = 0;
+            settling.reset(index);
+        });
+
+        differs.forEach([this, &policy](std::size_t index) {
+            const bool present = observed.test(index);
+            const uint8_t threshold =
+                present ? policy.insertion : policy.removal;
+
+            if (unsettled.test(index) || ++streaks.at(index) >= threshold)
+            {
+                debounced.set(index, present);
+                streaks.at(index) = 0;
+                settling.reset(index);
+            }
+            else
+            {
+                settling.set(index);
+            }
+        });
+
+        return recovered;
+    }
+
+    /* Forget any partial streak, e.g. when the connector's probe is dropped */
+    void reset(std::size_t index)
+    {
+        observed.reset(index);
+        debounced.reset(index);
+        unsettled.reset(index);
+        settling.reset(index);
+        streaks.at(index) = 0;
+    }
+
+    void clear()
+    {
+        observed.clear();
+        debounced.clear();
+        published.clear();
+        unsettled.clear();
+        settling.clear();
+        streaks.fill(0);
+        flaps.fill(0);
+    }
+};
+
+class PresenceListener
+{
+  public:
+    virtual ~PresenceListener() = default;
+
+    virtual void presenceChanged(ConnectorID id, bool present) = 0;
+
+    /* A disagreement in the connector's presence cleared before it applied */
+    virtual void presenceFlapped([[maybe_unused]] ConnectorID id) {}
+
+    /* The identity of the FRU behind a present connector, see Device */
+    virtual void presenceIdentified([[maybe_unused]] ConnectorID id,
+                                    [[maybe_unused]] uint32_t fingerprint)
+    {}
+};
+
+/*
+ * A connector transition as published on the Notifier's presence event bus.
+ * The previous state of a connector that hasn't published before is absent.
+ */
+struct PresenceEvent
+{
+    ConnectorID id;
+    bool previous;
+    bool present;
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+/*
+ * Receives batches of presence events. A batch holds the transitions
+ * published since the previous batch, in the order they were published, and
+ * is only valid for the duration of the call.
+ */
+class PresenceSubscriber
+{
+  public:
+    virtual ~PresenceSubscriber() = default;
+
+    virtual void presenceEvents(std::span<const PresenceEvent> events) = 0;
+};
+
+namespace presence
+{
+static constexpr ConnectorID unassigned = UINT16_MAX;
+
+/*
+ * The shared-memory layout of the presence table. Readers in other processes
+ * must check magic and version before consuming the entries. Each word is
+ * 32-bits so the layout is the same and accesses are lock-free across all the
+ * targets we build for.
+ *
+ * The table lives in /run and is retained across restarts of the daemon within
+ * a boot, identified by the kernel's boot ID.
+ */
+static constexpr uint32_t tableMagic = 0x50465244; /* "PFRD" */
+static constexpr uint32_t tableVersion = 4;
+static constexpr std::size_t tableCapacity = 128;
+
+enum State : uint32_t
+{
+    STATE_UNKNOWN = 0,
+    STATE_ABSENT,
+    STATE_PRESENT,
+};
+
+struct Entry
+{
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> transitions;
+    /* CLOCK_MONOTONIC time of the most recent transition */
+    std::atomic<uint32_t> seconds;
+    std::atomic<uint32_t> nanoseconds;
+    /* Presence changes that cleared before debouncing accepted them */
+    std::atomic<uint32_t> flaps;
+    /* Identifies the FRU while present, or 0 if nothing beyond presence does */
+    std::atomic<uint32_t> fingerprint;
+};
+
+/* A reader's copy of an Entry */
+struct Status
+{
+    uint32_t state;
+    uint32_t transitions;
+    uint32_t seconds;
+    uint32_t nanoseconds;
+    uint32_t flaps;
+    uint32_t fingerprint;
+};
+
+using Snapshot = std::array<Status, tableCapacity>;
+
+using Fingerprints = std::array<uint32_t, tableCapacity>;
+
+using BootID = std::array<uint8_t, 16>;
+
+struct Layout
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    BootID bootID;
+    /* Odd while an update is in progress, see PresenceTable::read() */
+    std::atomic<uint32_t> sequence;
+    std::array<Entry, tableCapacity> entries;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::is_standard_layout_v<Layout>);
+} // namespace presence
+
+/*
+ * Publishes connector presence into a memory-mapped file so co-located
+ * processes can poll it without involving D-Bus. Updates are published under a
+ * seqlock: there's a single writer (us) and readers retry if they observe the
+ * sequence number change underneath them.
+ */
+class PresenceTable : public PresenceListener
+{
+  public:
+    static constexpr const char* defaultPath =
+        "/run/platform-fru-detect/presence";
+
+    /* Take a consistent snapshot of a mapped table, for use by readers */
+    static bool read(const presence::Layout* table, presence::Snapshot& out);
+
+    /* The kernel's boot ID, or all zeros if it can't be determined */
+    static presence::BootID currentBootID();
+
+    explicit PresenceTable(const std::filesystem::path& path,
+                           const presence::BootID& bootID = currentBootID());
+    PresenceTable(const PresenceTable& other) = delete;
+    PresenceTable(PresenceTable&& other) = delete;
+    virtual ~PresenceTable();
+
+    PresenceTable& operator=(const PresenceTable& other) = delete;
+    PresenceTable& operator=(PresenceTable&& other) = delete;
+
+    /*
+     * The connectors a previous instance of the daemon unplugged from the
+     * inventory during this boot. Empty unless the table was restored.
+     */
+    PresenceBitmap<presence::tableCapacity> restoredAbsent() const;
+
+    /*
+     * The connectors a previous instance of the daemon left plugged in the
+     * inventory during this boot, and the fingerprints of their FRUs. Their
+     * devices are adopted rather than plugged, see Device::adopt().
+     */
+    PresenceBitmap<presence::tableCapacity> restoredPresent() const;
+    presence::Fingerprints restoredFingerprints() const;
+
+    /* PresenceListener */
+    void presenceChanged(ConnectorID id, bool present) override;
+    void presenceFlapped(ConnectorID id) override;
+    void presenceIdentified(ConnectorID id, uint32_t fingerprint) override;
+
+  private:
+    presence::Layout* table;
+    bool restored;
+};
+
+/* Tallies the connectors that are present, e.g. for the --once summary */
+class PresenceTally : public PresenceListener
+{
+  public:
+    std::size_t count() const
+    {
+        return present.count();
+    }
+
+    /* PresenceListener */
+    void presenceChanged(ConnectorID id, bool present) override
+    {
+        if (id >= presence::tableCapacity)
+        {
+            return;
+        }
+
+        if (present)
+        {
+            this->present.set(id);
+        }
+        else
+        {
+            this->present.reset(id);
+        }
+    }
+
+  private:
+    PresenceBitmap<presence::tableCapacity> present;
+};
@@ -0,0 +1,224 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+
+#include "startup.hpp"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+PHOSPHOR_LOG2_USING;
+
+using namespace std::chrono;
+
+/*
+ * Implements the sd_notify(3) datagram protocol directly rather than linking
+ * libsystemd for the sake of a single sendto().
+ */
+void startup::notify(const std::string& state)
+{
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    const char* socketPath = std::getenv("NOTIFY_SOCKET");
+    if (socketPath == nullptr)
+    {
+        return;
+    }
+
+    struct sockaddr_un addr{};
+    std::size_t len = ::strlen(socketPath);
+    if (len == 0 || len >= sizeof(addr.sun_path) ||
+        (socketPath[0] != '/' && socketPath[0] != '@'))
+    {
+        warning("Ignoring unsupported notify socket '{NOTIFY_SOCKET}'",
+                "NOTIFY_SOCKET", socketPath);
+        return;
+    }
+
+    addr.sun_family = AF_UNIX;
+    ::memcpy(&addr.sun_path[0], socketPath, len);
+    if (addr.sun_path[0] == '@')
+    {
+        /* Abstract namespace socket */
+        addr.sun_path[0] = '\0';
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+    {
+        warning("Failed to create notify socket: {ERRNO_DESCRIPTION}",
+                "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO", errno);
+        return;
+    }
+
+    socklen_t addrlen = offsetof(struct sockaddr_un, sun_path) + len;
+    ssize_t rc = ::sendto(fd, state.data(), state.size(), MSG_NOSIGNAL,
+                          reinterpret_cast<struct sockaddr*>(&addr), addrlen);
+    if (rc == -1)
+    {
+        warning("Failed to notify service manager: {ERRNO_DESCRIPTION}",
+                "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO", errno);
+    }
+
+    ::close(fd);
+}
+
+StartupReport::Phase::Phase(StartupReport* report, std::string&& name) :
+    report(report), name(std::move(name)), begin(steady_clock::now())
+{
+    if (report != nullptr)
+    {
+        report->begin(this->name);
+    }
+}
+
+StartupReport::Phase::~Phase()
+{
+    end();
+}
+
+void StartupReport::Phase::end()
+{
+    if (report == nullptr)
+    {
+        return;
+    }
+
+    report->record(std::move(name),
+                   duration_cast<Duration>(steady_clock::now() - begin));
+    report = nullptr;
+}
+
+StartupReport::StartupReport(const std::filesystem::path& marker) :
+    marker(marker), started(steady_clock::now()), readied(false)
+{}
+
+StartupReport::Phase StartupReport::phase(std::string&& name)
+{
+    return {this, std::move(name)};
+}
+
+void StartupReport::begin(const std::string& name)
+{
+    {
+        std::lock_guard guard(lock);
+        if (readied)
+        {
+            return;
+        }
+    }
+
+    startup::notify("STATUS=" + name);
+}
+
+void StartupReport::record(std::string&& name, Duration duration)
+{
+    std::lock_guard guard(lock);
+
+    /* Hot-plug work after startup isn't part of the report */
+    if (!readied)
+    {
+        phases.emplace_back(std::move(name), duration);
+    }
+}
+
+bool StartupReport::claimReport()
+{
+    if (marker.empty())
+    {
+        return true;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(marker.parent_path(), ec);
+
+    int fd = ::open(marker.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                    S_IRUSR | S_IWUSR);
+    if (fd == -1)
+    {
+        if (errno != EEXIST)
+        {
+            warning(
+                "Failed to create startup report marker '{MARKER_PATH}': {ERRNO_DESCRIPTION}",
+                "MARKER_PATH", marker.string(), "ERRNO_DESCRIPTION",
+                ::strerror(errno), "ERRNO", errno);
+        }
+        return false;
+    }
+
+    ::close(fd);
+
+    return true;
+}
+
+void StartupReport::ready()
+{
+    Duration total = getElapsed();
+
+    {
+        std::lock_guard guard(lock);
+        if (readied)
+        {
+            return;
+        }
+        readied = true;
+    }
+
+    startup::notify("READY=1\nSTATUS=Monitoring FRU presence");
+
+    if (!claimReport())
+    {
+        debug("Startup completed in {DURATION_US}us", "DURATION_US",
+              total.count());
+        return;
+    }
+
+    /* readied is set, so the phases are no longer modified */
+    for (const auto& [name, duration] : phases)
+    {
+        info("Startup phase '{STARTUP_PHASE}' took {DURATION_US}us",
+             "STARTUP_PHASE", name, "DURATION_US", duration.count());
+    }
+
+    info("Startup completed in {DURATION_US}us", "DURATION_US", total.count(),
+         "STARTUP_PHASES", phases.size());
+}
+
+void StartupReport::finish(const std::string& status)
+{
+    {
+        std::lock_guard guard(lock);
+        if (readied)
+        {
+            return;
+        }
+        readied = true;
+    }
+
+    startup::notify("READY=1\nSTATUS=" + status);
+}
+
+StartupReport::Duration StartupReport::getElapsed() const
+{
+    return duration_cast<Duration>(steady_clock::now() - started);
+}
+
+bool StartupReport::isReady()
+{
+    std::lock_guard guard(lock);
+    return readied;
+}
+
+std::vector<std::pair<std::string, StartupReport::Duration>>
+    StartupReport::getPhases()
+{
+    std::lock_guard guard(lock);
+    return phases;
+}
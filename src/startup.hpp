@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Tracks the phases of startup for the service manager and the journal.
+ *
+ * Each phase is reported to systemd as a STATUS= update when it begins, and
+ * its duration is recorded when it ends. ready() sends READY=1 and logs the
+ * recorded durations. finish() sends READY=1 for a daemon that exits without
+ * reaching ready(), so the service manager sees a clean exit rather than a
+ * protocol failure. The report is logged once per boot so restarts of the
+ * daemon don't drown out the timings of the initial start. Without a marker
+ * path the report is logged every time.
+ */
+class StartupReport
+{
+  public:
+    using Duration = std::chrono::microseconds;
+
+    class Phase
+    {
+      public:
+        Phase(StartupReport* report, std::string&& name);
+        Phase(const Phase& other) = delete;
+        Phase(Phase&& other) = delete;
+        ~Phase();
+
+        Phase& operator=(const Phase& other) = delete;
+        Phase& operator=(Phase&& other) = delete;
+
+        void end();
+
+      private:
+        StartupReport* report;
+        std::string name;
+        std::chrono::steady_clock::time_point begin;
+    };
+
+    static constexpr const char* defaultMarkerPath =
+        "/run/platform-fru-detect/startup-reported";
+
+    explicit StartupReport(
+        const std::filesystem::path& marker = defaultMarkerPath);
+    StartupReport(const StartupReport& other) = delete;
+    StartupReport(StartupReport&& other) = delete;
+    ~StartupReport() = default;
+
+    StartupReport& operator=(const StartupReport& other) = delete;
+    StartupReport& operator=(StartupReport&& other) = delete;
+
+    Phase phase(std::string&& name);
+    void ready();
+    void finish(const std::string& status);
+    bool isReady();
+
+    /* The time since the report was created */
+    Duration getElapsed() const;
+
+    /* The phases recorded so far, in the order they ended */
+    std::vector<std::pair<std::string, Duration>> getPhases();
+
+  private:
+    void begin(const std::string& name);
+    void record(std::string&& name, Duration duration);
+    bool claimReport();
+
+    std::filesystem::path marker;
+    std::chrono::steady_clock::time_point started;
+    /* Phases may be timed from a WorkPool during cold-plug */
+    std::mutex lock;
+    std::vector<std::pair<std::string, Duration>> phases;
+    bool readied;
+};
+
+namespace startup
+{
+/* Send a state update to the service manager, if there is one */
+void notify(const std::string& state);
+} // namespace startup
@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "sysfs/attribute.hpp"
+
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <system_error>
+
+PHOSPHOR_LOG2_USING;
+
+SysfsAttribute::SysfsAttribute(const std::filesystem::path& path, int flags) :
+    path(path),
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    fd(::open(path.c_str(), flags | O_CLOEXEC))
+{
+    if (fd == -1)
+    {
+        debug("Failed to open '{SYSFS_PATH}': {ERRNO_DESCRIPTION}",
+              "SYSFS_PATH", path.string(), "ERRNO_DESCRIPTION",
+              ::strerror(errno), "ERRNO", errno);
+        throw std::system_category().default_error_condition(errno);
+    }
+}
+
+SysfsAttribute::~SysfsAttribute()
+{
+    ::close(fd);
+}
+
+std::size_t SysfsAttribute::read(std::span<char> buffer, off_t offset) const
+{
+    ssize_t rc = -1;
+
+    do
+    {
+        rc = ::pread(fd, buffer.data(), buffer.size(), offset);
+    } while (rc == -1 && errno == EINTR);
+
+    if (rc == -1)
+    {
+        error("Failed to read '{SYSFS_PATH}': {ERRNO_DESCRIPTION}",
+              "SYSFS_PATH", path.string(), "ERRNO_DESCRIPTION",
+              ::strerror(errno), "ERRNO", errno);
+        throw std::system_category().default_error_condition(errno);
+    }
+
+    return static_cast<std::size_t>(rc);
+}
+
+void SysfsAttribute::write(std::string_view value) const
+{
+    ssize_t rc = -1;
+
+    /* sysfs consumes the value in a single write */
+    do
+    {
+        rc = ::write(fd, value.data(), value.size());
+    } while (rc == -1 && errno == EINTR);
+
+    if (rc == -1)
+    {
+        error("Failed to write '{SYSFS_PATH}': {ERRNO_DESCRIPTION}",
+              "SYSFS_PATH", path.string(), "ERRNO_DESCRIPTION",
+              ::strerror(errno), "ERRNO", errno);
+        throw std::system_category().default_error_condition(errno);
+    }
+
+    if (static_cast<std::size_t>(rc) != value.size())
+    {
+        error("Short write to '{SYSFS_PATH}', wrote {WRITE_SIZE} of {SIZE}",
+              "SYSFS_PATH", path.string(), "WRITE_SIZE", rc, "SIZE",
+              value.size());
+        throw std::system_category().default_error_condition(EIO);
+    }
+}
+
+std::size_t SysfsAttribute::read(const std::filesystem::path& path,
+                                 std::span<char> buffer)
+{
+    return SysfsAttribute(path).read(buffer);
+}
+
+void SysfsAttribute::write(const std::filesystem::path& path,
+                           std::string_view value)
+{
+    SysfsAttribute(path, O_WRONLY).write(value);
+}
+
+std::string sysfs::formatI2CDeviceID(int bus, int address)
+{
+    std::array<char, 16> id{};
+    char* end = id.data() + id.size();
+
+    char* sep = std::to_chars(id.data(), end, bus).ptr;
+    *sep++ = '-';
+
+    /* Zero-pad the address to four hex digits */
+    std::array<char, 8> digits{};
+    char* last =
+        std::to_chars(digits.data(), digits.data() + digits.size(), address, 16)
+            .ptr;
+    auto len = static_cast<std::size_t>(last - digits.data());
+    for (std::size_t i = len; i < 4; i++)
+    {
+        *sep++ = '0';
+    }
+    std::memcpy(sep, digits.data(), len);
+
+    return {id.data(), static_cast<std::size_t>(sep + len - id.data())};
+}
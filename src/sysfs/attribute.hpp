@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include <fcntl.h>
+#include <sys/types.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+/*
+ * Reads and writes sysfs attributes with plain system calls into
+ * caller-provided buffers, avoiding the allocations and locale handling of
+ * iostreams.
+ *
+ * An instance holds the attribute's descriptor open for attributes that are
+ * accessed repeatedly. By default each read() starts from the beginning of the
+ * attribute, as sysfs regenerates text content on every read from offset
+ * zero; binary attributes such as eeprom accept an offset. The static
+ * helpers suit attributes accessed once.
+ *
+ * Failures are logged and thrown as std::error_condition.
+ */
+class SysfsAttribute
+{
+  public:
+    SysfsAttribute() = delete;
+    explicit SysfsAttribute(const std::filesystem::path& path,
+                            int flags = O_RDONLY);
+    SysfsAttribute(const SysfsAttribute& other) = delete;
+    SysfsAttribute(SysfsAttribute&& other) = delete;
+    ~SysfsAttribute();
+
+    SysfsAttribute& operator=(const SysfsAttribute& other) = delete;
+    SysfsAttribute& operator=(SysfsAttribute&& other) = delete;
+
+    std::size_t read(std::span<char> buffer, off_t offset = 0) const;
+    void write(std::string_view value) const;
+
+    static std::size_t read(const std::filesystem::path& path,
+                            std::span<char> buffer);
+    static void write(const std::filesystem::path& path,
+                      std::string_view value);
+
+  private:
+    std::filesystem::path path;
+    int fd;
+};
+
+namespace sysfs
+{
+/* Format an I2C client ID such as '11-0075' */
+std::string formatI2CDeviceID(int bus, int address);
+} // namespace sysfs
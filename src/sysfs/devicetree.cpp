@@ -3,33 +3,21 @@
 
 #include "sysfs/devicetree.hpp"
 
-#include <phosphor-logging/lg2.hpp>
+#include "sysfs/attribute.hpp"
+#include "sysfs/sysfs.hpp"
 
-#include <fstream>
-
-PHOSPHOR_LOG2_USING;
+#include <array>
+#include <string_view>
 
 std::string SysfsDevicetree::getModel()
 {
-    std::filesystem::path path("/sys/firmware/devicetree/base/model");
-    std::ifstream property(path, std::ifstream::in);
-
-    if (!property.is_open())
-    {
-        error("Failed to open '{SYSFS_DEVICETREE_PLATFORM_MODEL_PATH}'",
-              "SYSFS_DEVICETREE_PLATFORM_MODEL_PATH", path.string());
-        throw -1;
-    }
+    std::filesystem::path path =
+        sysfs::rooted("/sys/firmware/devicetree/base/model");
+    std::array<char, 256> buffer{};
 
-    std::string model;
-    std::getline(property, model, '\0');
-    if (property.bad() || property.fail())
-    {
-        error(
-            "Failed while reading data from '{SYSFS_DEVICETREE_PLATFORM_MODEL_PATH}'",
-            "SYSFS_DEVICETREE_PLATFORM_MODEL_PATH", path.string());
-        throw -1;
-    }
+    std::size_t len = SysfsAttribute::read(path, buffer);
 
-    return model;
+    /* The property is NUL-terminated */
+    std::string_view model(buffer.data(), len);
+    return std::string(model.substr(0, model.find('\0')));
 }
@@ -2,7 +2,7 @@
 /* Copyright IBM Corp. 2021 */
 #include "sysfs/eeprom.hpp"
 
-#include "devices/nvme.hpp"
+#include "sysfs/attribute.hpp"
 
 bool SysfsEEPROM::isEEPROM(const std::filesystem::path& path)
 {
@@ -13,3 +13,23 @@ SysfsI2CDevice SysfsEEPROM::getDevice()
 {
     return SysfsI2CDevice{path.parent_path()};
 }
+
+std::size_t SysfsEEPROM::read(std::span<char> buffer, off_t offset) const
+{
+    SysfsAttribute eeprom(path);
+    std::size_t total = 0;
+
+    while (total < buffer.size())
+    {
+        std::size_t len = eeprom.read(buffer.subspan(total),
+                                      offset + static_cast<off_t>(total));
+        if (len == 0)
+        {
+            break;
+        }
+
+        total += len;
+    }
+
+    return total;
+}
@@ -5,7 +5,11 @@
 #include "sysfs/i2c.hpp"
 #include "sysfs/sysfs.hpp"
 
+#include <sys/types.h>
+
+#include <cstddef>
 #include <filesystem>
+#include <span>
 
 class SysfsEEPROM : public SysfsEntry
 {
@@ -25,4 +29,7 @@ class SysfsEEPROM : public SysfsEntry
     SysfsEEPROM& operator=(SysfsEEPROM&& other) = delete;
 
     SysfsI2CDevice getDevice();
+
+    /* Read from the EEPROM until the buffer is full or the data runs out */
+    std::size_t read(std::span<char> buffer, off_t offset = 0) const;
 };
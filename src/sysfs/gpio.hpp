@@ -8,6 +8,8 @@
 
 #include <filesystem>
 #include <iostream>
+#include <optional>
+#include <system_error>
 
 PHOSPHOR_LOG2_USING;
 
@@ -32,11 +34,23 @@ class SysfsGPIOChip : public SysfsEntry
         return path.filename();
     }
 
+    std::filesystem::path getDevice()
+    {
+        return sysfs::rooted(std::filesystem::path("/dev") / getName());
+    }
+
   private:
     static std::filesystem::path getGPIOChipPath(const SysfsEntry& entry)
     {
         namespace fs = std::filesystem;
 
+        std::optional<fs::path> indexed =
+            SysfsI2CTopology::instance().findGPIOChip(entry.getPath());
+        if (indexed)
+        {
+            return *indexed;
+        }
+
         debug("Inspecting '{SYSFS_PATH}' for associated gpiochip", "SYSFS_PATH",
               entry.getPath().string());
 
@@ -54,7 +68,6 @@ class SysfsGPIOChip : public SysfsEntry
         error("sysfs path '{SYSFS_PATH}' has no associated gpiochip",
               "SYSFS_PATH", entry.getPath().string());
 
-        /* FIXME: Throw something better? */
-        throw -1;
+        throw std::make_error_condition(std::errc::no_such_device);
     }
 };
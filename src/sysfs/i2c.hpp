@@ -4,9 +4,15 @@
 
 #include "sysfs/sysfs.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <map>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 
 class SysfsI2CMux;
 class SysfsI2CDevice;
@@ -39,11 +45,24 @@ class SysfsI2CDeviceDriverBindException : public std::exception
     std::string description;
 };
 
+/*
+ * Drivers bind to devices created through new_device asynchronously. A
+ * waiter lets probeDevice() block until the bind completes rather than
+ * failing if it hasn't yet.
+ */
+class SysfsI2CDriverBindWaiter
+{
+  public:
+    /* Returns true if the driver is known to have bound by the deadline */
+    virtual bool waitForDriver(int bus, int address,
+                               std::chrono::milliseconds timeout) = 0;
+};
+
 class SysfsI2CBus : public SysfsEntry
 {
   public:
     explicit SysfsI2CBus(const std::filesystem::path& path, bool check = true) :
-        SysfsEntry(path, check)
+        SysfsEntry(path, check), number(extractBusNumber(path))
     {}
     SysfsI2CBus(const SysfsI2CMux& mux, int channel);
 
@@ -66,6 +85,16 @@ class SysfsI2CBus : public SysfsEntry
     /* Require driver be bound */
     SysfsI2CDevice probeDevice(std::string type, int address);
     void removeDevice(int address);
+
+    static constexpr std::chrono::milliseconds driverBindTimeout{3000};
+    static void setDriverBindWaiter(SysfsI2CDriverBindWaiter* waiter);
+
+    /* The bus number for 'i2c-N' paths, otherwise -1 */
+    static int extractBusNumber(const std::filesystem::path& path);
+
+  private:
+    /* Cached so the hot paths don't have to resolve it through sysfs */
+    int number;
 };
 
 class SysfsI2CDevice : public SysfsEntry
@@ -80,6 +109,10 @@ class SysfsI2CDevice : public SysfsEntry
     std::string getID();
     int getAddress();
 
+    /* Extract the bus number and address from IDs such as '11-0075' */
+    static bool extractBusAddress(const std::string& id, int& bus,
+                                  int& address);
+
   private:
     static std::string generateI2CDeviceID(const SysfsI2CBus& bus, int address);
 };
@@ -96,5 +129,92 @@ class SysfsI2CMux : public SysfsI2CDevice
         SysfsI2CDevice(bus, address)
     {}
 
-    static int extractChannel(std::string& name);
+    static int extractChannel(std::string_view name);
+};
+
+/*
+ * An index of the I2C topology built from one walk of /sys/bus/i2c/devices:
+ * the adapters, the mux channels and the adapters they provide, and the
+ * client devices along with their gpiochips. Lookups are by bus number and
+ * device address and touch no files. The index is updated as devices are
+ * created and removed through SysfsI2CBus.
+ *
+ * Lookups fail before scan() succeeds, and callers fall back to discovering
+ * the topology through sysfs.
+ */
+class SysfsI2CTopology
+{
+  public:
+    static constexpr const char* defaultRoot = "/sys/bus/i2c/devices";
+
+    /* The index of the system's topology */
+    static SysfsI2CTopology& instance();
+
+    explicit SysfsI2CTopology(
+        const std::filesystem::path& root = defaultRoot);
+    SysfsI2CTopology(const SysfsI2CTopology& other) = delete;
+    SysfsI2CTopology(SysfsI2CTopology&& other) = delete;
+    ~SysfsI2CTopology() = default;
+
+    SysfsI2CTopology& operator=(const SysfsI2CTopology& other) = delete;
+    SysfsI2CTopology& operator=(SysfsI2CTopology&& other) = delete;
+
+    bool scan();
+    bool isIndexed();
+
+    /* Re-index a client device after it's created or its driver binds */
+    void update(int bus, int address);
+    void remove(int bus, int address);
+
+    std::optional<SysfsI2CBus> findBus(int bus);
+    std::optional<SysfsI2CBus> findMuxChannel(int bus, int muxAddress,
+                                              int channel);
+    std::optional<int> findMuxParent(int bus);
+    /* The physical adapter carrying a bus, through any mux channels */
+    int findRootAdapter(int bus);
+    bool hasDevice(int bus, int address);
+    std::optional<std::filesystem::path> findGPIOChip(int bus, int address);
+    std::optional<std::filesystem::path>
+        findGPIOChip(const std::filesystem::path& device);
+
+    /* Look up a mux channel through the index, falling back to sysfs */
+    SysfsI2CBus getMuxChannel(const SysfsI2CBus& bus, int muxAddress,
+                              int channel);
+
+  private:
+    struct Adapter
+    {
+        int parent;
+        int muxAddress;
+        int channel;
+    };
+
+    struct Client
+    {
+        std::string gpiochip;
+    };
+
+    static constexpr uint32_t clientKey(int bus, int address)
+    {
+        return (static_cast<uint32_t>(bus) << 16) |
+               static_cast<uint32_t>(address);
+    }
+
+    static constexpr uint32_t channelKey(int bus, int address, int channel)
+    {
+        return (static_cast<uint32_t>(bus) << 16) |
+               (static_cast<uint32_t>(address) << 8) |
+               static_cast<uint32_t>(channel);
+    }
+
+    std::filesystem::path getBusPath(int bus) const;
+    void indexClient(int bus, int address);
+    void dropClient(int bus, int address);
+
+    std::filesystem::path root;
+    std::shared_mutex lock;
+    bool indexed;
+    std::map<int, Adapter> adapters;
+    std::map<uint32_t, int> channels;
+    std::map<uint32_t, Client> clients;
 };
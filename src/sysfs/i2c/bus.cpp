@@ -2,14 +2,17 @@
 /* Copyright IBM Corp. 2021 */
 #include "sysfs/i2c.hpp"
 
+#include "sysfs/attribute.hpp"
+
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <charconv>
 #include <climits>
-#include <fstream>
-#include <iostream>
-#include <sstream>
+#include <system_error>
 
 PHOSPHOR_LOG2_USING_WITH_FLAGS;
 
@@ -18,20 +21,44 @@ static constexpr std::array<const char*, 8> muxChannelMap = {
     "channel-4", "channel-5", "channel-6", "channel-7",
 };
 
+static std::atomic<SysfsI2CDriverBindWaiter*> driverBindWaiter = nullptr;
+
+void SysfsI2CBus::setDriverBindWaiter(SysfsI2CDriverBindWaiter* waiter)
+{
+    driverBindWaiter = waiter;
+}
+
 SysfsI2CBus::SysfsI2CBus(const SysfsI2CMux& mux, int channel) :
-    SysfsEntry(mux.getPath() / muxChannelMap.at(channel))
+    SysfsEntry(mux.getPath() / muxChannelMap.at(channel)), number(-1)
 {}
 
-int SysfsI2CBus::getMuxChannel()
+int SysfsI2CBus::extractBusNumber(const std::filesystem::path& path)
 {
-    std::string name;
-    std::ifstream namestream(path / "name");
+    /* Extract 13 from '/sys/bus/i2c/devices/i2c-13' */
+    std::string name = path.filename().string();
+    if (!name.starts_with("i2c-"))
+    {
+        return -1;
+    }
 
-    assert(namestream.is_open());
-    std::getline(namestream, name);
-    namestream.close();
+    int bus = -1;
+    const char* begin = name.data() + 4;
+    const char* end = name.data() + name.size();
+    auto [ptr, ec] = std::from_chars(begin, end, bus);
+    if (ec != std::errc() || ptr != end || begin == end)
+    {
+        return -1;
+    }
 
-    return SysfsI2CMux::extractChannel(name);
+    return bus;
+}
+
+int SysfsI2CBus::getMuxChannel()
+{
+    std::array<char, 64> name{};
+    std::size_t len = SysfsAttribute::read(path / "name", name);
+
+    return SysfsI2CMux::extractChannel({name.data(), len});
 }
 
 bool SysfsI2CBus::isMuxBus()
@@ -41,6 +68,11 @@ bool SysfsI2CBus::isMuxBus()
 
 std::string SysfsI2CBus::getID() const
 {
+    if (number >= 0)
+    {
+        return path.filename().string();
+    }
+
     std::filesystem::path target;
 
     if (std::filesystem::is_symlink(path))
@@ -57,6 +89,11 @@ std::string SysfsI2CBus::getID() const
 
 int SysfsI2CBus::getAddress() const
 {
+    if (number >= 0)
+    {
+        return number;
+    }
+
     std::string name = getID();
     std::string::size_type pos = name.find('-');
 
@@ -65,20 +102,12 @@ int SysfsI2CBus::getAddress() const
 
 std::filesystem::path SysfsI2CBus::getBusDevice() const
 {
-    std::ostringstream ss;
-
-    ss << "/dev/i2c-" << getAddress();
-
-    return ss.str();
+    return sysfs::rooted("/dev/i2c-" + std::to_string(getAddress()));
 }
 
 std::filesystem::path SysfsI2CBus::getDevicePath(int address)
 {
-    std::ostringstream ss;
-    ss << getAddress() << "-" << std::setfill('0') << std::setw(4) << std::hex
-       << address;
-
-    return path / ss.str();
+    return path / sysfs::formatI2CDeviceID(getAddress(), address);
 }
 
 bool SysfsI2CBus::isDevicePresent(int address)
@@ -88,49 +117,66 @@ bool SysfsI2CBus::isDevicePresent(int address)
 
 SysfsI2CDevice SysfsI2CBus::newDevice(std::string type, int address)
 {
-    std::fstream newDevice(path / "new_device", std::fstream::out);
-    if (!newDevice.is_open())
+    /*
+     * I2C_NAME_SIZE is 20 including the terminator. The request leaves plenty
+     * for ' 0x' and the address.
+     */
+    std::array<char, 64> request{};
+    if (type.size() >= 20)
     {
-        warning("Failed to open '{SYSFS_I2C_NEW_DEVICE_PATH}'",
-                "SYSFS_I2C_NEW_DEVICE_PATH", path.string());
-        throw -1;
+        warning("Device type '{I2C_DEVICE_TYPE}' exceeds I2C_NAME_SIZE",
+                "I2C_DEVICE_TYPE", type);
+        throw std::system_category().default_error_condition(EINVAL);
     }
 
-    newDevice << type << " 0x" << std::hex << address << "\n";
-    newDevice.flush();
+    char* cursor = std::copy(type.begin(), type.end(), request.data());
+    *cursor++ = ' ';
+    *cursor++ = '0';
+    *cursor++ = 'x';
+    char* end = request.data() + request.size();
+    cursor = std::to_chars(cursor, end, address, 16).ptr;
+    *cursor++ = '\n';
 
-    if (newDevice.bad() || newDevice.fail())
+    try
+    {
+        SysfsAttribute::write(path / "new_device", {request.data(), cursor});
+    }
+    catch (const std::error_condition&)
     {
         warning(
             "Failed to add new device {I2C_DEVICE_TYPE} at {I2C_DEVICE_ADDRESS} via '{SYSFS_I2C_NEW_DEVICE_PATH}'",
             "I2C_DEVICE_TYPE", type, "I2C_DEVICE_ADDRESS", hex | field8,
             address, "SYSFS_I2C_NEW_DEVICE_PATH", path);
-        throw -1;
+        throw;
     }
 
+    SysfsI2CTopology::instance().update(getAddress(), address);
+
     return SysfsI2CDevice{getDevicePath(address)};
 }
 
 void SysfsI2CBus::deleteDevice(int address)
 {
-    std::fstream deleteDevice(path / "delete_device", std::fstream::out);
-    if (!deleteDevice.is_open())
-    {
-        warning("Failed to open '{SYSFS_I2C_DELETE_DEVICE_PATH}'",
-                "SYSFS_I2C_DELETE_DEVICE_PATH", path);
-        throw -1;
-    }
+    std::array<char, 16> request{'0', 'x'};
+    char* end = request.data() + request.size();
+    char* cursor = std::to_chars(request.data() + 2, end, address, 16).ptr;
+    *cursor++ = '\n';
 
-    deleteDevice << "0x" << std::hex << address << "\n";
-    deleteDevice.flush();
+    SysfsAttribute deleteDevice(path / "delete_device", O_WRONLY);
 
-    if (deleteDevice.bad() || deleteDevice.fail())
+    try
+    {
+        deleteDevice.write({request.data(), cursor});
+    }
+    catch (const std::error_condition&)
     {
         warning(
             "Failed to delete device at {I2C_DEVICE_ADDRESS} via '{SYSFS_I2C_DELETE_DEVICE_PATH}'",
             "I2C_DEVICE_ADDRESS", lg2::hex, address,
             "SYSFS_I2C_DELETE_DEVICE_PATH", path);
     }
+
+    SysfsI2CTopology::instance().remove(getAddress(), address);
 }
 
 SysfsI2CDevice SysfsI2CBus::requireDevice(std::string type, int address)
@@ -169,6 +215,14 @@ SysfsI2CDevice SysfsI2CBus::probeDevice(std::string type, int address)
         "Testing whether a driver is bound via symlink '{SYSFS_I2C_DEVICE_DRIVER_SYMLINK}'",
         "SYSFS_I2C_DEVICE_DRIVER_SYMLINK", driver.string());
 
+    SysfsI2CDriverBindWaiter* waiter = driverBindWaiter;
+    if (!std::filesystem::exists(driver) && waiter != nullptr)
+    {
+        debug("Waiting for a driver to bind to '{SYSFS_I2C_DEVICE_PATH}'",
+              "SYSFS_I2C_DEVICE_PATH", device.getPath());
+        waiter->waitForDriver(getAddress(), address, driverBindTimeout);
+    }
+
     if (!std::filesystem::exists(driver))
     {
         error("No driver bound for '{SYSFS_I2C_DEVICE_PATH}', removing device",
@@ -177,6 +231,9 @@ SysfsI2CDevice SysfsI2CBus::probeDevice(std::string type, int address)
         throw SysfsI2CDeviceDriverBindException(device);
     }
 
+    /* Binding the driver may have added mux channels or a gpiochip */
+    SysfsI2CTopology::instance().update(getAddress(), address);
+
     return device;
 }
 
@@ -2,6 +2,9 @@
 /* Copyright IBM Corp. 2021 */
 #include "sysfs/i2c.hpp"
 
+#include "sysfs/attribute.hpp"
+
+#include <charconv>
 #include <filesystem>
 #include <string>
 
@@ -10,18 +13,31 @@ namespace fs = std::filesystem;
 std::string SysfsI2CDevice::generateI2CDeviceID(const SysfsI2CBus& bus,
                                                 int address)
 {
-    std::ostringstream oss;
-
-    oss << bus.getAddress() << "-" << std::setfill('0') << std::setw(4)
-        << std::hex << address;
-
-    return oss.str();
+    return sysfs::formatI2CDeviceID(bus.getAddress(), address);
 }
 
 SysfsI2CDevice::SysfsI2CDevice(const SysfsI2CBus& bus, int address) :
     SysfsEntry(fs::path(bus.getPath() / generateI2CDeviceID(bus, address)))
 {}
 
+bool SysfsI2CDevice::extractBusAddress(const std::string& id, int& bus,
+                                       int& address)
+{
+    const char* begin = id.data();
+    const char* end = id.data() + id.size();
+
+    auto [sep, ec] = std::from_chars(begin, end, bus);
+    if (ec != std::errc() || sep == begin || sep == end || *sep != '-')
+    {
+        return false;
+    }
+
+    const char* digits = sep + 1;
+    auto [ptr, aec] = std::from_chars(digits, end, address, 16);
+
+    return aec == std::errc() && ptr == end && (end - digits) == 4;
+}
+
 std::string SysfsI2CDevice::getID()
 {
     return path.filename().string();
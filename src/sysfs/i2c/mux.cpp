@@ -3,17 +3,22 @@
 #include "sysfs/i2c.hpp"
 
 #include <cassert>
+#include <charconv>
 
-int SysfsI2CMux::extractChannel(std::string& name)
+int SysfsI2CMux::extractChannel(std::string_view name)
 {
     /* Extract '0' from 'i2c-29-mux (chan_id 0)' */
 
-    std::string::size_type pos = name.find(' ');
-    assert(pos != std::string::npos);
+    std::string_view::size_type pos = name.find(' ');
+    assert(pos != std::string_view::npos);
     pos = name.find('(', pos + 1);
-    assert(pos != std::string::npos);
+    assert(pos != std::string_view::npos);
     pos = name.find(' ', pos + 1);
-    assert(pos != std::string::npos);
+    assert(pos != std::string_view::npos);
 
-    return std::stoi(name.substr(pos + 1));
+    int channel = -1;
+    std::from_chars(name.data() + pos + 1, name.data() + name.size(),
+                    channel);
+
+    return channel;
 }
@@ -0,0 +1,276 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "sysfs/i2c.hpp"
+
+#include "sysfs/attribute.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <charconv>
+#include <mutex>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace fs = std::filesystem;
+
+/* Extract the channel from mux channel links such as 'channel-3' */
+static bool extractChannel(const std::string& name, int& channel)
+{
+    if (!name.starts_with("channel-"))
+    {
+        return false;
+    }
+
+    const char* begin = name.data() + 8;
+    const char* end = name.data() + name.size();
+    auto [ptr, ec] = std::from_chars(begin, end, channel);
+
+    return ec == std::errc() && ptr == end && begin != end;
+}
+
+SysfsI2CTopology& SysfsI2CTopology::instance()
+{
+    static SysfsI2CTopology topology(sysfs::rooted(defaultRoot));
+
+    return topology;
+}
+
+SysfsI2CTopology::SysfsI2CTopology(const fs::path& root) :
+    root(root), indexed(false)
+{}
+
+bool SysfsI2CTopology::scan()
+{
+    std::unique_lock guard(lock);
+
+    adapters.clear();
+    channels.clear();
+    clients.clear();
+    indexed = false;
+
+    std::error_code ec;
+    std::vector<std::pair<int, int>> found;
+    for (const auto& dirent : fs::directory_iterator(root, ec))
+    {
+        std::string name = dirent.path().filename().string();
+        int bus = SysfsI2CBus::extractBusNumber(dirent.path());
+        int address = -1;
+
+        if (bus >= 0)
+        {
+            adapters.try_emplace(bus, Adapter{-1, -1, -1});
+        }
+        else if (SysfsI2CDevice::extractBusAddress(name, bus, address))
+        {
+            found.emplace_back(bus, address);
+        }
+    }
+
+    if (ec)
+    {
+        warning("Failed to index I2C topology under '{SYSFS_PATH}': {ERROR}",
+                "SYSFS_PATH", root.string(), "ERROR", ec.message());
+        return false;
+    }
+
+    /* Index the clients once all the adapters are known */
+    for (const auto& [bus, address] : found)
+    {
+        indexClient(bus, address);
+    }
+
+    indexed = true;
+
+    debug(
+        "Indexed {ADAPTER_COUNT} I2C adapters, {CHANNEL_COUNT} mux channels and {CLIENT_COUNT} devices",
+        "ADAPTER_COUNT", adapters.size(), "CHANNEL_COUNT", channels.size(),
+        "CLIENT_COUNT", clients.size());
+
+    return true;
+}
+
+bool SysfsI2CTopology::isIndexed()
+{
+    std::shared_lock guard(lock);
+    return indexed;
+}
+
+fs::path SysfsI2CTopology::getBusPath(int bus) const
+{
+    return root / ("i2c-" + std::to_string(bus));
+}
+
+void SysfsI2CTopology::indexClient(int bus, int address)
+{
+    std::string name = sysfs::formatI2CDeviceID(bus, address);
+
+    Client client{};
+    std::error_code ec;
+    for (const auto& dirent : fs::directory_iterator(root / name, ec))
+    {
+        std::string entry = dirent.path().filename().string();
+        int channel = -1;
+
+        if (entry.starts_with("gpiochip"))
+        {
+            client.gpiochip = entry;
+        }
+        else if (extractChannel(entry, channel))
+        {
+            std::error_code lec;
+            fs::path target = fs::read_symlink(dirent.path(), lec);
+            int child = SysfsI2CBus::extractBusNumber(target);
+            if (lec || child < 0)
+            {
+                continue;
+            }
+
+            channels.insert_or_assign(channelKey(bus, address, channel), child);
+            adapters.insert_or_assign(child, Adapter{bus, address, channel});
+        }
+    }
+
+    if (ec)
+    {
+        debug("Failed to index I2C device {I2C_DEVICE}: {ERROR}", "I2C_DEVICE",
+              name, "ERROR", ec.message());
+        return;
+    }
+
+    clients.insert_or_assign(clientKey(bus, address), std::move(client));
+}
+
+void SysfsI2CTopology::dropClient(int bus, int address)
+{
+    clients.erase(clientKey(bus, address));
+
+    auto first = channels.lower_bound(channelKey(bus, address, 0));
+    auto last = channels.upper_bound(channelKey(bus, address, 0xff));
+    for (auto it = first; it != last; ++it)
+    {
+        adapters.erase(it->second);
+    }
+    channels.erase(first, last);
+}
+
+void SysfsI2CTopology::update(int bus, int address)
+{
+    std::unique_lock guard(lock);
+    if (!indexed || bus < 0)
+    {
+        return;
+    }
+
+    dropClient(bus, address);
+    indexClient(bus, address);
+}
+
+void SysfsI2CTopology::remove(int bus, int address)
+{
+    std::unique_lock guard(lock);
+    if (!indexed || bus < 0)
+    {
+        return;
+    }
+
+    dropClient(bus, address);
+}
+
+std::optional<SysfsI2CBus> SysfsI2CTopology::findBus(int bus)
+{
+    std::shared_lock guard(lock);
+    if (!adapters.contains(bus))
+    {
+        return std::nullopt;
+    }
+
+    return SysfsI2CBus(getBusPath(bus), false);
+}
+
+std::optional<SysfsI2CBus>
+    SysfsI2CTopology::findMuxChannel(int bus, int muxAddress, int channel)
+{
+    std::shared_lock guard(lock);
+    auto found = channels.find(channelKey(bus, muxAddress, channel));
+    if (found == channels.end())
+    {
+        return std::nullopt;
+    }
+
+    return SysfsI2CBus(getBusPath(found->second), false);
+}
+
+std::optional<int> SysfsI2CTopology::findMuxParent(int bus)
+{
+    std::shared_lock guard(lock);
+    auto found = adapters.find(bus);
+    if (found == adapters.end() || found->second.parent < 0)
+    {
+        return std::nullopt;
+    }
+
+    return found->second.parent;
+}
+
+int SysfsI2CTopology::findRootAdapter(int bus)
+{
+    std::shared_lock guard(lock);
+
+    for (auto found = adapters.find(bus);
+         found != adapters.end() && found->second.parent >= 0;
+         found = adapters.find(bus))
+    {
+        bus = found->second.parent;
+    }
+
+    return bus;
+}
+
+bool SysfsI2CTopology::hasDevice(int bus, int address)
+{
+    std::shared_lock guard(lock);
+    return clients.contains(clientKey(bus, address));
+}
+
+std::optional<fs::path> SysfsI2CTopology::findGPIOChip(int bus, int address)
+{
+    std::shared_lock guard(lock);
+    auto found = clients.find(clientKey(bus, address));
+    if (found == clients.end() || found->second.gpiochip.empty())
+    {
+        return std::nullopt;
+    }
+
+    return root / sysfs::formatI2CDeviceID(bus, address) /
+           found->second.gpiochip;
+}
+
+std::optional<fs::path> SysfsI2CTopology::findGPIOChip(const fs::path& device)
+{
+    int bus = -1;
+    int address = -1;
+
+    std::string id = device.filename().string();
+    if (!SysfsI2CDevice::extractBusAddress(id, bus, address))
+    {
+        return std::nullopt;
+    }
+
+    return findGPIOChip(bus, address);
+}
+
+SysfsI2CBus SysfsI2CTopology::getMuxChannel(const SysfsI2CBus& bus,
+                                            int muxAddress, int channel)
+{
+    std::optional<SysfsI2CBus> indexed =
+        findMuxChannel(bus.getAddress(), muxAddress, channel);
+    if (indexed)
+    {
+        return *indexed;
+    }
+
+    return {SysfsI2CMux(bus, muxAddress), channel};
+}
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "sysfs/sysfs.hpp"
+
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+static fs::path sysfsRoot;
+
+void sysfs::setRoot(const fs::path& root)
+{
+    fs::path normal = root.lexically_normal();
+
+    /* Drop any trailing separator so prefix comparisons are exact */
+    if (!normal.empty() && !normal.has_filename())
+    {
+        normal = normal.parent_path();
+    }
+
+    sysfsRoot = (normal == normal.root_path()) ? fs::path() : normal;
+}
+
+const fs::path& sysfs::getRoot()
+{
+    return sysfsRoot;
+}
+
+fs::path sysfs::rooted(const fs::path& path)
+{
+    if (sysfsRoot.empty() || !path.is_absolute())
+    {
+        return path;
+    }
+
+    /* Paths derived from an entry's path are already beneath the root */
+    auto last = std::mismatch(sysfsRoot.begin(), sysfsRoot.end(), path.begin(),
+                              path.end())
+                    .first;
+    if (last == sysfsRoot.end())
+    {
+        return path;
+    }
+
+    return sysfsRoot / path.relative_path();
+}
@@ -8,23 +8,37 @@
 #include <iostream>
 #include <system_error>
 
+namespace sysfs
+{
+/*
+ * Relocate the kernel interfaces - /sys, /dev and the devicetree beneath
+ * them - under a prefix so the stack can run against a fake tree. Set the
+ * root before any sysfs access; it isn't synchronised.
+ */
+void setRoot(const std::filesystem::path& root);
+const std::filesystem::path& getRoot();
+
+/* Resolve an absolute kernel path such as '/sys/bus/i2c' under the root */
+std::filesystem::path rooted(const std::filesystem::path& path);
+} // namespace sysfs
+
 class SysfsEntry
 {
   public:
     SysfsEntry() = delete;
     explicit SysfsEntry(const std::filesystem::path& path, bool check = true) :
-        path(path)
+        path(sysfs::rooted(path))
     {
-        if (check && !std::filesystem::exists(path))
+        if (check && !std::filesystem::exists(this->path))
         {
             lg2::error("sysfs path '{SYSFS_PATH}' does not exist", "SYSFS_PATH",
-                       path.string());
+                       this->path.string());
 
             throw std::system_category().default_error_condition(ENOENT);
         }
 
         lg2::debug("Instantiated SysfsEntry for '{SYSFS_PATH}'", "SYSFS_PATH",
-                   path.string());
+                   this->path.string());
     }
     SysfsEntry(const SysfsEntry& other) = default;
     SysfsEntry(SysfsEntry&& other) = default;
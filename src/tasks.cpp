@@ -0,0 +1,231 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+
+#include "tasks.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cassert>
+#include <optional>
+
+PHOSPHOR_LOG2_USING;
+
+static thread_local WorkPool* attachedPool = nullptr;
+static thread_local std::size_t attachedQueue = 0;
+
+/* WorkPool */
+
+WorkPool* WorkPool::current()
+{
+    return attachedPool;
+}
+
+WorkPool::WorkPool(unsigned int workers) :
+    queued(0), stopping(false), previous(attachedPool)
+{
+    for (unsigned int i = 0; i <= workers; i++)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    attachedPool = this;
+    attachedQueue = 0;
+
+    for (unsigned int i = 1; i <= workers; i++)
+    {
+        this->workers.emplace_back(&WorkPool::work, this, i);
+    }
+
+    debug("Started work pool with {WORKERS} workers", "WORKERS", workers);
+}
+
+WorkPool::~WorkPool()
+{
+    {
+        std::lock_guard guard(idleLock);
+        stopping = true;
+    }
+    idle.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    attachedPool = previous;
+}
+
+void WorkPool::submit(Task&& task)
+{
+    /* Prefer the local queue, other threads steal from the opposite end */
+    std::size_t self = attachedPool == this ? attachedQueue : 0;
+
+    {
+        std::lock_guard guard(queues[self]->lock);
+        queues[self]->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard guard(idleLock);
+        queued++;
+    }
+    idle.notify_all();
+}
+
+bool WorkPool::runOne()
+{
+    std::size_t self = attachedQueue;
+    std::optional<Task> task;
+
+    for (std::size_t i = 0; i < queues.size() && !task; i++)
+    {
+        std::size_t victim = (self + i) % queues.size();
+        Queue& queue = *queues[victim];
+
+        std::lock_guard guard(queue.lock);
+        if (queue.tasks.empty())
+        {
+            continue;
+        }
+
+        if (victim == self)
+        {
+            task.emplace(std::move(queue.tasks.back()));
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task.emplace(std::move(queue.tasks.front()));
+            queue.tasks.pop_front();
+        }
+
+        queued--;
+    }
+
+    if (!task)
+    {
+        return false;
+    }
+
+    try
+    {
+        task->work();
+    }
+    catch (...)
+    {
+        task->group->fail(std::current_exception());
+    }
+
+    taskCompleted(task->group);
+
+    return true;
+}
+
+void WorkPool::waitFor(const std::atomic<std::size_t>& outstanding)
+{
+    while (outstanding > 0)
+    {
+        if (runOne())
+        {
+            continue;
+        }
+
+        std::unique_lock guard(idleLock);
+        idle.wait(guard, [&]() { return outstanding == 0 || queued > 0; });
+    }
+}
+
+void WorkPool::taskCompleted(TaskGroup* group)
+{
+    {
+        std::lock_guard guard(idleLock);
+        group->outstanding--;
+    }
+    idle.notify_all();
+}
+
+void WorkPool::work(std::size_t self)
+{
+    attachedPool = this;
+    attachedQueue = self;
+
+    for (;;)
+    {
+        if (runOne())
+        {
+            continue;
+        }
+
+        std::unique_lock guard(idleLock);
+        idle.wait(guard, [this]() { return stopping || queued > 0; });
+        if (stopping && queued == 0)
+        {
+            break;
+        }
+    }
+}
+
+/* TaskGroup */
+
+TaskGroup::TaskGroup() : pool(WorkPool::current()), outstanding(0) {}
+
+TaskGroup::~TaskGroup()
+{
+    /*
+     * The work may reference the frame that owns the group, so if the owner
+     * is unwinding before it could wait(), finish the work before the frame
+     * goes. Failures of the abandoned work are dropped.
+     */
+    if (pool != nullptr && outstanding > 0)
+    {
+        debug("Waiting for {TASK_COUNT} tasks of a TaskGroup destroyed early",
+              "TASK_COUNT", outstanding.load());
+        pool->waitFor(outstanding);
+    }
+
+    assert(outstanding == 0 && "Bad state: TaskGroup destroyed with work");
+}
+
+void TaskGroup::spawn(std::function<void()>&& work)
+{
+    if (pool == nullptr)
+    {
+        try
+        {
+            work();
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+        return;
+    }
+
+    outstanding++;
+    pool->submit({std::move(work), this});
+}
+
+void TaskGroup::wait()
+{
+    if (pool != nullptr)
+    {
+        pool->waitFor(outstanding);
+    }
+
+    std::lock_guard guard(failureLock);
+    if (failure)
+    {
+        std::exception_ptr ex = failure;
+        failure = nullptr;
+        std::rethrow_exception(ex);
+    }
+}
+
+void TaskGroup::fail(std::exception_ptr&& ex)
+{
+    std::lock_guard guard(failureLock);
+    if (!failure)
+    {
+        failure = std::move(ex);
+    }
+}
@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+
+/*
+ * A small work-stealing pool for cold-plugging independent parts of the
+ * platform concurrently. Constructing a WorkPool attaches it to the calling
+ * thread until it is destroyed. Work is submitted through a TaskGroup, which
+ * runs the work inline if there is no pool attached. Threads waiting on a
+ * TaskGroup execute queued work rather than block so nested groups can't
+ * exhaust the pool.
+ */
+class WorkPool
+{
+  public:
+    static constexpr unsigned int defaultWorkers = 4;
+
+    static WorkPool* current();
+
+    explicit WorkPool(unsigned int workers = defaultWorkers);
+    WorkPool(const WorkPool& other) = delete;
+    WorkPool(WorkPool&& other) = delete;
+    ~WorkPool();
+
+    WorkPool& operator=(const WorkPool& other) = delete;
+    WorkPool& operator=(WorkPool&& other) = delete;
+
+  private:
+    friend class TaskGroup;
+
+    struct Task
+    {
+        std::function<void()> work;
+        TaskGroup* group;
+    };
+
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void submit(Task&& task);
+    bool runOne();
+    void waitFor(const std::atomic<std::size_t>& outstanding);
+    void taskCompleted(TaskGroup* group);
+    void work(std::size_t self);
+
+    /* queues[0] belongs to the attached thread, the rest to the workers */
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued;
+    std::mutex idleLock;
+    std::condition_variable idle;
+    bool stopping;
+    WorkPool* previous;
+};
+
+/*
+ * Spawned work may complete in any order. wait() returns once all of it has
+ * completed, rethrowing the first exception raised by the work if any. The
+ * destructor also waits for outstanding work, so work may safely reference
+ * the spawning frame even if it unwinds before calling wait().
+ */
+class TaskGroup
+{
+  public:
+    TaskGroup();
+    TaskGroup(const TaskGroup& other) = delete;
+    TaskGroup(TaskGroup&& other) = delete;
+    ~TaskGroup();
+
+    TaskGroup& operator=(const TaskGroup& other) = delete;
+    TaskGroup& operator=(TaskGroup&& other) = delete;
+
+    void spawn(std::function<void()>&& work);
+    void wait();
+
+  private:
+    friend class WorkPool;
+
+    void fail(std::exception_ptr&& ex);
+
+    WorkPool* pool;
+    std::atomic<std::size_t> outstanding;
+    std::mutex failureLock;
+    std::exception_ptr failure;
+};
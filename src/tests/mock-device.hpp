@@ -0,0 +1,39 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include "notify.hpp"
+#include "platform.hpp"
+
+struct MockDeviceState
+{
+    int plugged;
+    int unplugged;
+};
+
+/* Counts the plug() and unplug() calls it receives */
+class MockDevice : public Device
+{
+  public:
+    explicit MockDevice(MockDeviceState* state) : state(state) {}
+    MockDevice(const MockDevice& other) = delete;
+    MockDevice(MockDevice&& other) = delete;
+    virtual ~MockDevice() = default;
+
+    MockDevice& operator=(const MockDevice& other) = delete;
+    MockDevice& operator=(MockDevice&& other) = delete;
+
+    void plug([[maybe_unused]] Notifier& notifier) override
+    {
+        state->plugged++;
+    }
+
+    void unplug([[maybe_unused]] Notifier& notifier,
+                [[maybe_unused]] int mode = UNPLUG_REMOVES_INVENTORY) override
+    {
+        state->unplugged++;
+    }
+
+  private:
+    MockDeviceState* state;
+};
@@ -66,7 +66,8 @@ void MockInventory::removePropertiesChangedListener(
     throw std::logic_error("Unimplemented");
 }
 
-void MockInventory::add(const std::string& path, interfaces::Interface iface)
+void MockInventory::add(const std::string& path,
+                        const interfaces::Interface& iface)
 {
     ObjectType update;
 
@@ -75,7 +76,8 @@ void MockInventory::add(const std::string& path, interfaces::Interface iface)
     accumulate(store, path, update);
 }
 
-void MockInventory::remove(const std::string& path, interfaces::Interface iface)
+void MockInventory::remove(const std::string& path,
+                           const interfaces::Interface& iface)
 {
     ObjectType update;
 
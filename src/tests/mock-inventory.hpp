@@ -16,9 +16,9 @@ struct MockInventory : public Inventory
     void removePropertiesChangedListener(
         std::weak_ptr<dbus::PropertiesChangedListener> listener) override;
     void add(const std::string& path,
-             inventory::interfaces::Interface iface) override;
+             const inventory::interfaces::Interface& iface) override;
     void remove(const std::string& path,
-                inventory::interfaces::Interface iface) override;
+                const inventory::interfaces::Interface& iface) override;
     void markPresent(const std::string& path) override;
     void markAbsent(const std::string& path) override;
     bool isPresent(const std::string& path) override;
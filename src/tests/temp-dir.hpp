@@ -0,0 +1,44 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+/* A fresh directory under the system temp directory, removed on destruction */
+class TemporaryDirectory
+{
+  public:
+    explicit TemporaryDirectory(const std::string& prefix)
+    {
+        std::string tmpl = std::filesystem::temp_directory_path() /
+                           (prefix + "-XXXXXX");
+        if (::mkdtemp(tmpl.data()) == nullptr)
+        {
+            throw std::system_category().default_error_condition(errno);
+        }
+        path = tmpl;
+    }
+    TemporaryDirectory(const TemporaryDirectory& other) = delete;
+    TemporaryDirectory(TemporaryDirectory&& other) = delete;
+    ~TemporaryDirectory()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    TemporaryDirectory& operator=(const TemporaryDirectory& other) = delete;
+    TemporaryDirectory& operator=(TemporaryDirectory&& other) = delete;
+
+    const std::filesystem::path& getPath() const
+    {
+        return path;
+    }
+
+  private:
+    std::filesystem::path path;
+};
@@ -0,0 +1,375 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "devices/nvme.hpp"
+#include "mock-device.hpp"
+#include "notify.hpp"
+#include "platform.hpp"
+#include "platforms/backplane.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <span>
+#include <string>
+
+#include "gtest/gtest.h"
+
+/*
+ * Replace the global allocator so the tests can assert the connector and
+ * poller lifecycles don't touch the heap once the platform is constructed.
+ */
+static std::atomic<bool> counting = false;
+static std::atomic<std::size_t> allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    if (counting)
+    {
+        allocations++;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+    std::free(ptr);
+}
+
+class HeapAllocationCounter
+{
+  public:
+    HeapAllocationCounter()
+    {
+        allocations = 0;
+        counting = true;
+    }
+    HeapAllocationCounter(const HeapAllocationCounter& other) = delete;
+    HeapAllocationCounter(HeapAllocationCounter&& other) = delete;
+    ~HeapAllocationCounter()
+    {
+        counting = false;
+    }
+
+    HeapAllocationCounter&
+        operator=(const HeapAllocationCounter& other) = delete;
+    HeapAllocationCounter& operator=(HeapAllocationCounter&& other) = delete;
+
+    std::size_t stop()
+    {
+        counting = false;
+        return allocations;
+    }
+};
+
+class FlagPresence
+{
+  public:
+    explicit FlagPresence(const bool* flag) : flag(flag) {}
+
+    bool operator()() const
+    {
+        return *flag;
+    }
+
+  private:
+    const bool* flag;
+};
+
+/* Discards updates so only the device's own allocations are counted */
+class NullInventory : public Inventory
+{
+  public:
+    void migrate(
+        [[maybe_unused]] std::span<inventory::Migration*>&& migrations) override
+    {}
+
+    std::weak_ptr<dbus::PropertiesChangedListener> addPropertiesChangedListener(
+        [[maybe_unused]] const std::string& path,
+        [[maybe_unused]] const std::string& interface,
+        [[maybe_unused]] std::function<void(dbus::PropertiesChanged&&)>
+            callback) override
+    {
+        return {};
+    }
+
+    void removePropertiesChangedListener(
+        [[maybe_unused]] std::weak_ptr<dbus::PropertiesChangedListener>
+            listener) override
+    {}
+
+    void add([[maybe_unused]] const std::string& path,
+             [[maybe_unused]] const inventory::interfaces::Interface& iface)
+        override
+    {}
+
+    void remove([[maybe_unused]] const std::string& path,
+                [[maybe_unused]] const inventory::interfaces::Interface& iface)
+        override
+    {}
+
+    void markPresent([[maybe_unused]] const std::string& path) override {}
+    void markAbsent([[maybe_unused]] const std::string& path) override {}
+
+    bool isPresent([[maybe_unused]] const std::string& path) override
+    {
+        return false;
+    }
+
+    bool isModel([[maybe_unused]] const std::string& path,
+                 [[maybe_unused]] const std::string& model) override
+    {
+        return false;
+    }
+};
+
+struct AllocationBackplaneTraits
+{
+    static constexpr const char* name = "AllocationBackplane";
+    static constexpr bool driveEndpoint = false;
+    static constexpr bool qualifiedDriveNames = true;
+    static constexpr ConnectorID driveConnectorIDBase = 0;
+    static constexpr const char* drivePresenceDeviceType = "pca9552";
+    static constexpr int drivePresenceDeviceAddress = 0x60;
+    static constexpr std::array<int, 2> drivePresenceMap = {0, 1};
+
+    static SysfsI2CBus getDrivePresenceBus([[maybe_unused]] int instance)
+    {
+        return SysfsI2CBus("/sys/bus/i2c/devices/i2c-1", false);
+    }
+};
+
+class AllocationBackplane :
+    public GpioPresenceBackplane<AllocationBackplaneTraits>
+{
+  public:
+    explicit AllocationBackplane(Inventory* inventory) :
+        GpioPresenceBackplane<AllocationBackplaneTraits>(
+            inventory, 0, "/system/chassis/motherboard/disk_backplane0")
+    {}
+};
+
+static const std::string drivePath =
+    "/xyz/openbmc_project/inventory/system/chassis/motherboard/drive0";
+
+/* A drive with the endpoint metadata supplied rather than read over I2C */
+class MetadataNVMeDrive : public BasicNVMeDrive, public Device
+{
+  public:
+    MetadataNVMeDrive(Inventory* inventory, const SysfsI2CBus* bus,
+                      std::span<const uint8_t> metadata) :
+        BasicNVMeDrive(*bus, drivePath, metadata), inventory(inventory)
+    {}
+
+    /* Device */
+    void plug([[maybe_unused]] Notifier& notifier) override
+    {
+        addToInventory(inventory);
+    }
+
+    void unplug([[maybe_unused]] Notifier& notifier,
+                [[maybe_unused]] int mode = UNPLUG_REMOVES_INVENTORY) override
+    {
+        removeFromInventory(inventory);
+    }
+
+    uint32_t getFingerprint() const override
+    {
+        return BasicNVMeDrive::getFingerprint();
+    }
+
+  private:
+    Inventory* inventory;
+};
+
+class CountingSubscriber : public PresenceSubscriber
+{
+  public:
+    void presenceEvents(std::span<const PresenceEvent> events) override
+    {
+        received += events.size();
+    }
+
+    std::size_t received = 0;
+};
+
+TEST(HeapAllocations, connectorCycles)
+{
+    constexpr int cycles = 1000;
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    Connector<MockDevice> connector(0, &state);
+
+    connector.identify(0);
+
+    HeapAllocationCounter counter;
+    for (int i = 0; i < cycles; i++)
+    {
+        connector.populate(notifier);
+        connector.depopulate(notifier);
+    }
+    std::size_t allocated = counter.stop();
+
+    EXPECT_EQ(0U, allocated);
+    EXPECT_EQ(cycles, state.plugged);
+    EXPECT_EQ(cycles, state.unplugged);
+}
+
+TEST(HeapAllocations, pollTicks)
+{
+    constexpr int ticks = 1000;
+    constexpr int period = 10;
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    PolledConnector<MockDevice, FlagPresence> connector(0, &state);
+    bool present = false;
+
+    connector.identify(0);
+    connector.start(notifier, FlagPresence(&present));
+
+    HeapAllocationCounter counter;
+    for (int i = 0; i < ticks; i++)
+    {
+        /* Flap the device every period ticks */
+        present = ((i / period) % 2) != 0;
+        connector.sample(notifier);
+    }
+    std::size_t allocated = counter.stop();
+
+    connector.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+
+    EXPECT_EQ(0U, allocated);
+    /* The final period is present, so stopping the connector unplugs it */
+    EXPECT_EQ(ticks / period / 2, state.plugged);
+    EXPECT_EQ(ticks / period / 2 + 1, state.unplugged);
+}
+
+TEST(HeapAllocations, arrayPollTicks)
+{
+    constexpr int ticks = 1000;
+    constexpr int period = 10;
+    Notifier notifier;
+    std::array<MockDeviceState, 16> states{};
+    PolledConnectorArray<MockDevice, FlagPresence, 16> connectors(
+        [&states](int index) {
+            return Connector<MockDevice>(index, &states.at(index));
+        });
+    std::array<bool, 16> present{};
+
+    connectors.identify(0);
+    for (std::size_t i = 0; i < present.size(); i++)
+    {
+        connectors.start(notifier, i, FlagPresence(&present.at(i)));
+    }
+
+    HeapAllocationCounter counter;
+    for (int i = 0; i < ticks; i++)
+    {
+        /* Flap every other connector every period ticks */
+        for (std::size_t j = 0; j < present.size(); j += 2)
+        {
+            present.at(j) = ((i / period) % 2) != 0;
+        }
+        connectors.sample(notifier);
+    }
+    std::size_t allocated = counter.stop();
+
+    connectors.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+
+    EXPECT_EQ(0U, allocated);
+    EXPECT_EQ(ticks / period / 2, states.at(0).plugged);
+    EXPECT_EQ(ticks / period / 2 + 1, states.at(0).unplugged);
+    /* Connectors that never change are only visited to settle them */
+    EXPECT_EQ(0, states.at(1).plugged);
+    EXPECT_EQ(1, states.at(1).unplugged);
+}
+
+TEST(HeapAllocations, presenceEvents)
+{
+    constexpr int cycles = 1000;
+    Notifier notifier;
+    CountingSubscriber subscriber;
+    MockDeviceState state{0, 0};
+    Connector<MockDevice> connector(0, &state);
+
+    connector.identify(0);
+    notifier.addPresenceSubscriber(&subscriber);
+
+    HeapAllocationCounter counter;
+    for (int i = 0; i < cycles; i++)
+    {
+        connector.populate(notifier);
+        connector.depopulate(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+        notifier.flushPresenceEvents();
+    }
+    std::size_t allocated = counter.stop();
+
+    notifier.removePresenceSubscriber(&subscriber);
+
+    EXPECT_EQ(0U, allocated);
+    EXPECT_EQ(static_cast<std::size_t>(2 * cycles), subscriber.received);
+}
+
+TEST(HeapAllocations, gpioDriveCycles)
+{
+    constexpr int cycles = 1000;
+    Notifier notifier;
+    NullInventory inventory;
+    AllocationBackplane backplane(&inventory);
+    Connector<GpioPresenceNVMeDrive<AllocationBackplaneTraits>> connector(
+        0, &inventory, &backplane, 0);
+
+    connector.identify(0);
+
+    HeapAllocationCounter counter;
+    for (int i = 0; i < cycles; i++)
+    {
+        connector.populate(notifier);
+        connector.depopulate(notifier);
+    }
+    std::size_t allocated = counter.stop();
+
+    EXPECT_EQ(0U, allocated);
+}
+
+TEST(HeapAllocations, endpointDriveCycles)
+{
+    constexpr int cycles = 1000;
+    Notifier notifier;
+    NullInventory inventory;
+    const SysfsI2CBus bus("/sys/bus/i2c/devices/i2c-2", false);
+    const std::array<uint8_t, 6> metadata = {0x14, 0x4d, 'S', 'N', '0', '1'};
+    Connector<MetadataNVMeDrive> connector(0, &inventory, &bus,
+                                           std::span(metadata));
+
+    connector.identify(0);
+
+    /* The first plug of a drive builds its inventory interfaces */
+    connector.populate(notifier);
+    connector.depopulate(notifier);
+
+    HeapAllocationCounter counter;
+    for (int i = 0; i < cycles; i++)
+    {
+        connector.populate(notifier);
+        connector.depopulate(notifier);
+    }
+    std::size_t allocated = counter.stop();
+
+    EXPECT_EQ(0U, allocated);
+}
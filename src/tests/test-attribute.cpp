@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "sysfs/attribute.hpp"
+#include "sysfs/i2c.hpp"
+#include "temp-dir.hpp"
+
+#include <array>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+class SysfsAttributeTest : public ::testing::Test
+{
+  protected:
+    TemporaryDirectory dir{"attribute"};
+    const fs::path& root = dir.getPath();
+};
+
+TEST_F(SysfsAttributeTest, readOnce)
+{
+    std::ofstream(root / "name") << "i2c-29-mux (chan_id 3)\n";
+
+    std::array<char, 64> buffer{};
+    std::size_t len = SysfsAttribute::read(root / "name", buffer);
+
+    EXPECT_EQ("i2c-29-mux (chan_id 3)\n", std::string(buffer.data(), len));
+    EXPECT_EQ(3, SysfsI2CMux::extractChannel({buffer.data(), len}));
+}
+
+TEST_F(SysfsAttributeTest, readRepeatedlyFromStart)
+{
+    std::ofstream(root / "value") << "1\n";
+
+    SysfsAttribute attribute(root / "value");
+    std::array<char, 8> buffer{};
+
+    EXPECT_EQ(2, attribute.read(buffer));
+    EXPECT_EQ(2, attribute.read(buffer));
+    EXPECT_EQ('1', buffer[0]);
+}
+
+TEST_F(SysfsAttributeTest, write)
+{
+    std::ofstream(root / "new_device").close();
+
+    SysfsAttribute::write(root / "new_device", "24c02 0x50\n");
+
+    std::string content;
+    std::getline(std::ifstream(root / "new_device"), content);
+    EXPECT_EQ("24c02 0x50", content);
+}
+
+TEST_F(SysfsAttributeTest, missing)
+{
+    std::array<char, 8> buffer{};
+
+    try
+    {
+        SysfsAttribute::read(root / "missing", buffer);
+        FAIL();
+    }
+    catch (const std::error_condition& err)
+    {
+        EXPECT_EQ(ENOENT, err.value());
+    }
+}
+
+TEST(SysfsI2CDeviceID, format)
+{
+    EXPECT_EQ("3-0050", sysfs::formatI2CDeviceID(3, 0x50));
+    EXPECT_EQ("11-0075", sysfs::formatI2CDeviceID(11, 0x75));
+    EXPECT_EQ("130-0a01", sysfs::formatI2CDeviceID(130, 0xa01));
+}
@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "mock-inventory.hpp"
+#include "notify.hpp"
+#include "platforms/backplane.hpp"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+struct MockBackplaneTraits
+{
+    static constexpr const char* name = "MockBackplane";
+    static constexpr bool driveEndpoint = false;
+    static constexpr bool qualifiedDriveNames = true;
+    static constexpr ConnectorID driveConnectorIDBase = 0;
+    static constexpr const char* drivePresenceDeviceType = "pca9552";
+    static constexpr int drivePresenceDeviceAddress = 0x60;
+    static constexpr std::array<int, 4> drivePresenceMap = {4, 5, 6, 7};
+
+    static SysfsI2CBus getDrivePresenceBus(int instance)
+    {
+        return SysfsI2CBus(
+            "/sys/bus/i2c/devices/i2c-" + std::to_string(instance), false);
+    }
+};
+
+struct MockUnqualifiedBackplaneTraits : public MockBackplaneTraits
+{
+    static constexpr bool qualifiedDriveNames = false;
+};
+
+template <typename Traits>
+class MockBackplane : public GpioPresenceBackplane<Traits>
+{
+  public:
+    MockBackplane(Inventory* inventory, int index) :
+        GpioPresenceBackplane<Traits>(
+            inventory, index,
+            "/system/chassis/motherboard/disk_backplane" +
+                std::to_string(index))
+    {}
+};
+
+TEST(GpioPresenceBackplane, qualifiedDriveInventoryPath)
+{
+    MockInventory inventory{};
+    MockBackplane<MockBackplaneTraits> backplane(&inventory, 1);
+    GpioPresenceNVMeDrive<MockBackplaneTraits> drive(&inventory, &backplane, 3);
+
+    EXPECT_EQ("/system/chassis/motherboard/disk_backplane1/nvme3/dp1_drive3",
+              drive.getInventoryPath());
+}
+
+TEST(GpioPresenceBackplane, unqualifiedDriveInventoryPath)
+{
+    MockInventory inventory{};
+    MockBackplane<MockUnqualifiedBackplaneTraits> backplane(&inventory, 0);
+    GpioPresenceNVMeDrive<MockUnqualifiedBackplaneTraits> drive(
+        &inventory, &backplane, 2);
+
+    EXPECT_EQ("/system/chassis/motherboard/disk_backplane0/nvme2/drive2",
+              drive.getInventoryPath());
+}
+
+TEST(GpioPresenceBackplane, sharedDriveInventoryPath)
+{
+    MockInventory inventory{};
+    MockBackplane<MockBackplaneTraits> backplane(&inventory, 0);
+    GpioPresenceNVMeDrive<MockBackplaneTraits> drive(&inventory, &backplane, 1);
+
+    /* The drive refers to the path computed by the backplane */
+    EXPECT_EQ(&backplane.getDriveInventoryPath(1), &drive.getInventoryPath());
+}
+
+TEST(GpioPresenceBackplane, drivePresence)
+{
+    Notifier notifier;
+    MockInventory inventory{};
+    MockBackplane<MockBackplaneTraits> backplane(&inventory, 0);
+    Connector<GpioPresenceNVMeDrive<MockBackplaneTraits>> connector(
+        0, &inventory, &backplane, 0);
+    std::string path =
+        "/system/chassis/motherboard/disk_backplane0/nvme0/dp0_drive0";
+
+    connector.populate(notifier);
+    EXPECT_TRUE(inventory.isPresent(path));
+
+    connector.depopulate(notifier, Device::UNPLUG_RETAINS_INVENTORY);
+    EXPECT_TRUE(inventory.isPresent(path));
+
+    connector.populate(notifier);
+    connector.depopulate(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+    EXPECT_FALSE(inventory.isPresent(path));
+}
@@ -1,7 +1,13 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 /* Copyright IBM Corp. 2021 */
+#include "inventory/migrations.hpp"
 #include "mock-inventory.hpp"
 
+#include <latch>
+#include <sstream>
+#include <string>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 // NOLINTNEXTLINE(readability-identifier-naming)
@@ -308,3 +314,68 @@ TEST(PublishWhenPresent, removeInterfacesAndSetAbsent)
     EXPECT_EQ(absent, inventory.store);
     EXPECT_EQ(false, inventory.present.at(TEST_PATH));
 }
+
+/* Records whether the item was marked present when the migration ran */
+class ObservingMigration : public Migration
+{
+  public:
+    ObservingMigration(const MockInventory* inventory, bool* marked) :
+        Migration("observing"), inventory(inventory), marked(marked)
+    {}
+
+    enum Result
+        migrate([[maybe_unused]] Inventory* inventory,
+                [[maybe_unused]] const std::string& path,
+                [[maybe_unused]] const ObjectType& object) const override
+    {
+        *marked = this->inventory->present.contains(TEST_PATH);
+        return Result::SUCCESS;
+    }
+
+  private:
+    const MockInventory* inventory;
+    bool* marked;
+};
+
+TEST(SynchronisedInventory, heldUntilMigrated)
+{
+    MockInventory inventory{};
+    SynchronisedInventoryDecorator synchronised(&inventory);
+    bool markedBeforeMigration = true;
+    ObservingMigration migration(&inventory, &markedBeforeMigration);
+    std::latch publishing(1);
+
+    /* The migration is applied to each object in the inventory */
+    inventory.add(TEST_PATH_1, interfaces::I2CDevice{1, 2});
+    synchronised.hold();
+
+    std::thread publisher([&synchronised, &publishing]() {
+        publishing.count_down();
+        synchronised.markPresent(TEST_PATH);
+    });
+
+    publishing.wait();
+    Inventory::migrate(&synchronised, std::move(migration));
+    publisher.join();
+
+    EXPECT_FALSE(markedBeforeMigration);
+    EXPECT_TRUE(inventory.present.at(TEST_PATH));
+}
+
+TEST(RecordingInventory, recordsOperations)
+{
+    std::ostringstream out;
+    RecordingInventory inventory(out);
+
+    EXPECT_FALSE(inventory.isPresent(TEST_PATH));
+    inventory.markPresent(TEST_PATH);
+    EXPECT_TRUE(inventory.isPresent(TEST_PATH));
+    inventory.add(TEST_PATH, interfaces::I2CDevice{1, 2});
+
+    EXPECT_EQ(4U, inventory.getOperationCount());
+    std::string set = "Set /xyz/openbmc_project/inventory" +
+                      std::string(TEST_PATH) + " " + INVENTORY_ITEM_IFACE +
+                      " Present true";
+    EXPECT_NE(std::string::npos, out.str().find(set));
+    EXPECT_NE(std::string::npos, out.str().find("Bus = 1"));
+}
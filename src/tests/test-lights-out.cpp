@@ -18,7 +18,7 @@ class MockNVMeDrive : public NVMeDrive, public FRU, public Device
         NVMeDrive(), inventory(inventory), basic(0, eepromAddress),
         vini(std::vector<uint8_t>({'N', 'V', 'M', 'e'}),
              std::vector<uint8_t>({'A', 'B', 'C', 'D'})),
-        index(index)
+        index(index), path(getInventoryPathFor(index))
     {}
 
     static std::string getInventoryPathFor(int index)
@@ -27,9 +27,9 @@ class MockNVMeDrive : public NVMeDrive, public FRU, public Device
                std::to_string(index);
     }
 
-    std::string getInventoryPath() const override
+    const std::string& getInventoryPath() const override
     {
-        return getInventoryPathFor(index);
+        return path;
     }
 
     void plug([[maybe_unused]] Notifier& notifier) override
@@ -48,6 +48,7 @@ class MockNVMeDrive : public NVMeDrive, public FRU, public Device
     const inventory::interfaces::I2CDevice basic;
     const inventory::interfaces::VINI vini;
     int index;
+    const std::string path;
 };
 
 class MockWilliwakasNVMeDrive : public MockNVMeDrive
@@ -67,13 +68,13 @@ class MockWilliwakasNVMeDrive : public MockNVMeDrive
 
     void addToInventory(Inventory* inventory) override
     {
-        std::string path = getInventoryPath();
+        const std::string& path = getInventoryPath();
         inventory->markPresent(path);
     }
 
     void removeFromInventory(Inventory* inventory) override
     {
-        std::string path = getInventoryPath();
+        const std::string& path = getInventoryPath();
         inventory->markAbsent(path);
     }
 };
@@ -93,14 +94,14 @@ class MockFlettNVMeDrive : public MockNVMeDrive
 
     void addToInventory(Inventory* inventory) override
     {
-        std::string path = getInventoryPath();
+        const std::string& path = getInventoryPath();
         inventory->add(path, basic);
         inventory->add(path, vini);
     }
 
     void removeFromInventory(Inventory* inventory) override
     {
-        std::string path = getInventoryPath();
+        const std::string& path = getInventoryPath();
         inventory->remove(path, basic);
         inventory->remove(path, vini);
     }
@@ -1,17 +1,22 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 /* Copyright IBM Corp. 2022 */
 #include "devices/nvme.hpp"
+#include "mock-inventory.hpp"
 #include "sysfs/i2c.hpp"
 
+#include <span>
+#include <vector>
+
 #include "gtest/gtest.h"
 
+static const std::string drivePath =
+    "/xyz/openbmc_project/inventory/system/chassis/motherboard/drive0";
+
 class TestNVMeDrive : public BasicNVMeDrive, public Device
 {
   public:
-    TestNVMeDrive(const SysfsI2CBus& bus,
-                  const std::vector<uint8_t>&& metadata) :
-        // NOLINTNEXTLINE(performance-move-const-arg)
-        BasicNVMeDrive(bus, "", std::move(metadata))
+    TestNVMeDrive(const SysfsI2CBus& bus, std::span<const uint8_t> metadata) :
+        BasicNVMeDrive(bus, drivePath, metadata)
     {}
 
     /* Device */
@@ -19,6 +24,11 @@ class TestNVMeDrive : public BasicNVMeDrive, public Device
     void unplug([[maybe_unused]] Notifier& notifier,
                 [[maybe_unused]] int mode = UNPLUG_REMOVES_INVENTORY) override
     {}
+
+    uint32_t getFingerprint() const override
+    {
+        return BasicNVMeDrive::getFingerprint();
+    }
 };
 
 TEST(DriveMetadata, smallMetadata)
@@ -26,3 +36,49 @@ TEST(DriveMetadata, smallMetadata)
     SysfsI2CBus bus("/sys/bus/i2c/devices/i2c-0", false);
     auto drive = TestNVMeDrive(bus, std::vector<uint8_t>{0, 1, 0x44});
 }
+
+TEST(DriveMetadata, recordReusedWhileUnchanged)
+{
+    SysfsI2CBus bus("/sys/bus/i2c/devices/i2c-1", false);
+    std::vector<uint8_t> first{0x14, 0x4d, 'S', 'N', '1'};
+    std::vector<uint8_t> second{0x14, 0x4d, 'S', 'N', '2'};
+    MockInventory inventory;
+
+    TestNVMeDrive(bus, first).addToInventory(&inventory);
+    inventory::ObjectType published = inventory.store.at(drivePath);
+
+    /* The same drive again publishes the same interfaces */
+    TestNVMeDrive(bus, first).addToInventory(&inventory);
+    EXPECT_EQ(published, inventory.store.at(drivePath));
+
+    /* A different drive on the bus publishes its own serial */
+    TestNVMeDrive(bus, second).addToInventory(&inventory);
+    EXPECT_NE(published, inventory.store.at(drivePath));
+}
+
+TEST(DriveMetadata, fingerprint)
+{
+    SysfsI2CBus bus("/sys/bus/i2c/devices/i2c-2", false);
+    std::vector<uint8_t> first{0x14, 0x4d, 'S', 'N', '1'};
+    std::vector<uint8_t> second{0x14, 0x4d, 'S', 'N', '2'};
+    const uint32_t fingerprint = BasicNVMeDrive::fingerprint(first);
+
+    EXPECT_NE(0U, fingerprint);
+    EXPECT_NE(fingerprint, BasicNVMeDrive::fingerprint(second));
+    EXPECT_EQ(fingerprint, TestNVMeDrive(bus, first).getFingerprint());
+
+    /* An adopted drive reports what it was adopted with until verified */
+    EXPECT_EQ(fingerprint, BasicNVMeDrive(drivePath, fingerprint)
+                               .getFingerprint());
+}
+
+TEST(HostPower, transitions)
+{
+    HostPower power;
+
+    EXPECT_TRUE(power.isOn());
+    EXPECT_FALSE(power.set(true));
+    EXPECT_TRUE(power.set(false));
+    EXPECT_FALSE(power.isOn());
+    EXPECT_TRUE(power.set(true));
+}
@@ -1,44 +1,16 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 /* Copyright IBM Corp. 2022 */
+#include "mock-device.hpp"
 #include "notify.hpp"
 #include "platform.hpp"
 
+#include <array>
+#include <csignal>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
-struct MockDeviceState
-{
-    int plugged;
-    int unplugged;
-};
-
-class MockDevice : public Device
-{
-  public:
-    explicit MockDevice(MockDeviceState* state) : state(state) {}
-    MockDevice(const MockDevice& other) = delete;
-    MockDevice(MockDevice&& other) = delete;
-    virtual ~MockDevice() = default;
-
-    MockDevice& operator=(const MockDevice& other) = delete;
-    MockDevice& operator=(MockDevice&& other) = delete;
-
-    void plug([[maybe_unused]] Notifier& notifier) override
-    {
-        state->plugged++;
-    }
-
-    void unplug([[maybe_unused]] Notifier& notifier,
-                [[maybe_unused]] int mode = UNPLUG_REMOVES_INVENTORY) override
-    {
-        state->unplugged++;
-    }
-
-  private:
-    MockDeviceState* state;
-};
-
 TEST(ConnectorActions, populateFromInit)
 {
     Notifier notifier;
@@ -130,3 +102,458 @@ TEST(ConnectorActions, populateFromDepopulated)
     EXPECT_EQ(1, state.plugged);
     EXPECT_EQ(1, state.unplugged);
 }
+
+class MockPresence
+{
+  public:
+    explicit MockPresence(const bool* present) : present(present) {}
+
+    bool operator()() const
+    {
+        return *present;
+    }
+
+  private:
+    const bool* present;
+};
+
+/* Requires two consecutive present samples before reporting presence */
+class MockLatchedPresence
+{
+  public:
+    explicit MockLatchedPresence(const bool* present) :
+        present(present), observed(0)
+    {}
+
+    bool operator()()
+    {
+        observed = *present ? observed + 1 : 0;
+        return observed >= 2;
+    }
+
+  private:
+    const bool* present;
+    int observed;
+};
+
+/* Records the bus of each sample */
+class MockBusPresence
+{
+  public:
+    MockBusPresence(int bus, std::vector<int>* visits) :
+        bus(bus), visits(visits)
+    {}
+
+    bool operator()() const
+    {
+        visits->push_back(bus);
+        return true;
+    }
+
+    int getBus() const
+    {
+        return bus;
+    }
+
+    static int getAdapter()
+    {
+        return adapter;
+    }
+
+    static bool usesBus()
+    {
+        return true;
+    }
+
+    static constexpr int adapter = 1000;
+
+  private:
+    int bus;
+    std::vector<int>* visits;
+};
+
+static_assert(PresenceProbe<MockPresence>);
+static_assert(PresenceProbe<MockLatchedPresence>);
+static_assert(!PresenceProbe<int>);
+static_assert(BusProbe<MockBusPresence>);
+static_assert(!BusProbe<MockPresence>);
+
+TEST(PolledConnectorActions, sampleAbsent)
+{
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    PolledConnector<MockDevice, MockPresence> connector(0, &state);
+    bool present = false;
+
+    connector.start(notifier, MockPresence(&present));
+    connector.sample(notifier);
+
+    EXPECT_EQ(0, state.plugged);
+    EXPECT_EQ(1, state.unplugged);
+
+    connector.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+}
+
+TEST(PolledConnectorActions, samplePresent)
+{
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    PolledConnector<MockDevice, MockPresence> connector(0, &state);
+    bool present = true;
+
+    connector.start(notifier, MockPresence(&present));
+    connector.sample(notifier);
+
+    EXPECT_EQ(1, state.plugged);
+    EXPECT_EQ(0, state.unplugged);
+
+    connector.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+
+    EXPECT_EQ(1, state.plugged);
+    EXPECT_EQ(1, state.unplugged);
+}
+
+TEST(PolledConnectorActions, sampleTransitions)
+{
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    PolledConnector<MockDevice, MockPresence> connector(0, &state);
+    bool present = true;
+
+    connector.start(notifier, MockPresence(&present));
+    connector.sample(notifier);
+    connector.sample(notifier);
+
+    EXPECT_EQ(1, state.plugged);
+    EXPECT_EQ(0, state.unplugged);
+
+    present = false;
+    connector.sample(notifier);
+    connector.sample(notifier);
+
+    EXPECT_EQ(1, state.plugged);
+    EXPECT_EQ(1, state.unplugged);
+
+    present = true;
+    connector.sample(notifier);
+
+    EXPECT_EQ(2, state.plugged);
+    EXPECT_EQ(1, state.unplugged);
+
+    connector.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+}
+
+TEST(PolledConnectorActions, probeRetainsState)
+{
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    PolledConnector<MockDevice, MockLatchedPresence> connector(0, &state);
+    bool present = true;
+
+    connector.start(notifier, MockLatchedPresence(&present));
+    connector.sample(notifier);
+
+    EXPECT_EQ(0, state.plugged);
+
+    connector.sample(notifier);
+
+    EXPECT_EQ(1, state.plugged);
+
+    connector.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+}
+
+TEST(PolledConnectorActions, sampleAfterStop)
+{
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    PolledConnector<MockDevice, MockPresence> connector(0, &state);
+    bool present = true;
+
+    connector.start(notifier, MockPresence(&present));
+    connector.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+
+    EXPECT_EQ(0, state.plugged);
+    EXPECT_EQ(1, state.unplugged);
+
+    connector.sample(notifier);
+
+    EXPECT_EQ(0, state.plugged);
+    EXPECT_EQ(1, state.unplugged);
+}
+
+template <std::size_t N>
+static PolledConnectorArray<MockDevice, MockPresence, N>
+    makeConnectors(std::array<MockDeviceState, N>& states)
+{
+    return PolledConnectorArray<MockDevice, MockPresence, N>(
+        [&states](int index) {
+            return Connector<MockDevice>(index, &states.at(index));
+        });
+}
+
+TEST(PolledConnectorArrayActions, sampleSettlesStartedConnectors)
+{
+    Notifier notifier;
+    std::array<MockDeviceState, 3> states{};
+    auto connectors = makeConnectors(states);
+    std::array<bool, 3> present = {true, false, true};
+
+    connectors.start(notifier, 0, MockPresence(&present.at(0)));
+    connectors.start(notifier, 1, MockPresence(&present.at(1)));
+    connectors.sample(notifier);
+
+    EXPECT_EQ(1, states.at(0).plugged);
+    EXPECT_EQ(0, states.at(0).unplugged);
+    /* Absent at start, so the device is unplugged to clean up the inventory */
+    EXPECT_EQ(0, states.at(1).plugged);
+    EXPECT_EQ(1, states.at(1).unplugged);
+    /* Not started */
+    EXPECT_EQ(0, states.at(2).plugged);
+    EXPECT_EQ(0, states.at(2).unplugged);
+
+    EXPECT_FALSE(connectors.getPresence().pending().any());
+
+    connectors.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+}
+
+TEST(PolledConnectorArrayActions, sampleVisitsChangedConnectors)
+{
+    Notifier notifier;
+    std::array<MockDeviceState, 4> states{};
+    auto connectors = makeConnectors(states);
+    std::array<bool, 4> present = {true, true, false, false};
+
+    for (std::size_t i = 0; i < present.size(); i++)
+    {
+        connectors.start(notifier, i, MockPresence(&present.at(i)));
+    }
+    connectors.sample(notifier);
+    connectors.sample(notifier);
+
+    EXPECT_EQ(1, states.at(0).plugged);
+    EXPECT_EQ(1, states.at(1).plugged);
+    EXPECT_EQ(1, states.at(2).unplugged);
+    EXPECT_EQ(1, states.at(3).unplugged);
+
+    present.at(1) = false;
+    present.at(2) = true;
+    connectors.sample(notifier);
+
+    EXPECT_EQ(1, states.at(0).plugged);
+    EXPECT_EQ(0, states.at(0).unplugged);
+    EXPECT_EQ(1, states.at(1).unplugged);
+    EXPECT_EQ(1, states.at(2).plugged);
+    EXPECT_EQ(1, states.at(3).unplugged);
+    EXPECT_TRUE(connectors.getPresence().published.test(2));
+    EXPECT_FALSE(connectors.getPresence().published.test(1));
+
+    connectors.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+
+    EXPECT_EQ(1, states.at(0).unplugged);
+    EXPECT_EQ(2, states.at(2).unplugged);
+}
+
+class MockDebouncedDevice : public MockDevice
+{
+  public:
+    static constexpr DebouncePolicy debounce{2, 3};
+
+    using MockDevice::MockDevice;
+};
+
+class FlapListener : public PresenceListener
+{
+  public:
+    void presenceChanged([[maybe_unused]] ConnectorID id,
+                         [[maybe_unused]] bool present) override
+    {}
+
+    void presenceFlapped(ConnectorID id) override
+    {
+        flapped.push_back(id);
+    }
+
+    std::vector<ConnectorID> flapped;
+};
+
+TEST(PolledConnectorArrayActions, sampleDebouncesTransitions)
+{
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    PolledConnectorArray<MockDebouncedDevice, MockPresence, 1> connectors(
+        [&state](int index) {
+            return Connector<MockDebouncedDevice>(index, &state);
+        });
+    FlapListener listener;
+    bool present = true;
+
+    connectors.identify(7);
+    notifier.addPresenceListener(&listener);
+
+    /* Started connectors settle on their first sample */
+    connectors.start(notifier, 0, MockPresence(&present));
+    connectors.sample(notifier);
+    EXPECT_EQ(1, state.plugged);
+
+    /* A glitch shorter than the removal threshold is counted, not applied */
+    present = false;
+    connectors.sample(notifier);
+    connectors.sample(notifier);
+    present = true;
+    connectors.sample(notifier);
+    EXPECT_EQ(0, state.unplugged);
+    EXPECT_EQ(1, connectors.getPresence().flaps.at(0));
+    EXPECT_FALSE(connectors.getPresence().settling.test(0));
+    EXPECT_EQ((std::vector<ConnectorID>{7}), listener.flapped);
+
+    present = false;
+    connectors.sample(notifier);
+    connectors.sample(notifier);
+    EXPECT_EQ(0, state.unplugged);
+    EXPECT_TRUE(connectors.getPresence().settling.test(0));
+    connectors.sample(notifier);
+    EXPECT_EQ(1, state.unplugged);
+    EXPECT_FALSE(connectors.getPresence().debounced.test(0));
+
+    present = true;
+    connectors.sample(notifier);
+    EXPECT_EQ(1, state.plugged);
+    connectors.sample(notifier);
+    EXPECT_EQ(2, state.plugged);
+
+    notifier.removePresenceListener(&listener);
+    connectors.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+}
+
+TEST(PolledConnectorActions, sampleDebouncesTransitions)
+{
+    Notifier notifier;
+    MockDeviceState state{0, 0};
+    PolledConnector<MockDebouncedDevice, MockPresence> connector(0, &state);
+    FlapListener listener;
+    bool present = true;
+
+    connector.identify(3);
+    notifier.addPresenceListener(&listener);
+
+    EXPECT_EQ(nullptr, connector.getPresence());
+
+    connector.start(notifier, MockPresence(&present));
+    connector.sample(notifier);
+    EXPECT_EQ(1, state.plugged);
+
+    present = false;
+    connector.sample(notifier);
+    present = true;
+    connector.sample(notifier);
+    EXPECT_EQ(0, state.unplugged);
+    ASSERT_NE(nullptr, connector.getPresence());
+    EXPECT_EQ(1, connector.getPresence()->flaps.at(0));
+    EXPECT_EQ((std::vector<ConnectorID>{3}), listener.flapped);
+
+    notifier.removePresenceListener(&listener);
+    connector.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+}
+
+TEST(PolledConnectorArrayActions, sampleAfterStop)
+{
+    Notifier notifier;
+    std::array<MockDeviceState, 2> states{};
+    auto connectors = makeConnectors(states);
+    std::array<bool, 2> present = {true, true};
+
+    connectors.start(notifier, 0, MockPresence(&present.at(0)));
+    connectors.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+    connectors.sample(notifier);
+
+    EXPECT_EQ(0, states.at(0).plugged);
+    EXPECT_EQ(1, states.at(0).unplugged);
+    EXPECT_EQ(0, states.at(1).plugged);
+    EXPECT_EQ(1, states.at(1).unplugged);
+}
+
+/* The bus budget is global, so restore it however the test exits */
+class PolledConnectorArrayBudget : public ::testing::Test
+{
+  protected:
+    void TearDown() override
+    {
+        PollPolicies::instance().setBusBudget(PollPolicies::defaultBusBudget);
+    }
+};
+
+TEST_F(PolledConnectorArrayBudget, sampleBudgetsBusProbes)
+{
+    Notifier notifier;
+    std::array<MockDeviceState, 4> states{};
+    PolledConnectorArray<MockDevice, MockBusPresence, 4> connectors(
+        [&states](int index) {
+            return Connector<MockDevice>(index, &states.at(index));
+        });
+    std::array<int, 4> buses = {13, 11, 12, 10};
+    std::vector<int> visits;
+
+    PollPolicies::instance().setBusBudget(2);
+
+    for (std::size_t i = 0; i < buses.size(); i++)
+    {
+        connectors.start(notifier, i, MockBusPresence(buses.at(i), &visits));
+    }
+
+    /* Probes are visited in bus order, and cold-plug isn't budgeted */
+    connectors.sample(notifier);
+    EXPECT_EQ((std::vector<int>{10, 11, 12, 13}), visits);
+
+    /* Beyond the budget, settled probes are deferred and keep their state */
+    visits.clear();
+    connectors.sample(notifier);
+    EXPECT_EQ((std::vector<int>{10, 11}), visits);
+
+    visits.clear();
+    connectors.sample(notifier);
+    EXPECT_TRUE(visits.empty());
+    EXPECT_TRUE(connectors.getPresence().published.test(0));
+    EXPECT_TRUE(connectors.getPresence().published.test(2));
+
+    /* Deferred probes are visited first once there's budget */
+    PollPolicies::instance().setBusBudget(0);
+    visits.clear();
+    connectors.sample(notifier);
+    EXPECT_EQ((std::vector<int>{12, 13, 10, 11}), visits);
+
+    connectors.stop(notifier, Device::UNPLUG_REMOVES_INVENTORY);
+}
+
+TEST(UnplugModeForExit, interruptRemovesDevices)
+{
+    Notifier notifier;
+
+    ASSERT_EQ(0, ::raise(SIGINT));
+    notifier.run();
+
+    EXPECT_EQ(SIGINT, notifier.getExitSignal());
+    EXPECT_EQ(Device::UNPLUG_RETAINS_INVENTORY, unplugModeForExit(notifier));
+}
+
+TEST(UnplugModeForExit, plannedRestartRetainsDevices)
+{
+    Notifier notifier;
+
+    ASSERT_EQ(0, ::raise(SIGTERM));
+    notifier.run();
+
+    EXPECT_EQ(SIGTERM, notifier.getExitSignal());
+    EXPECT_EQ(Device::UNPLUG_RETAINS_DEVICES, unplugModeForExit(notifier));
+}
+
+TEST(UnplugModeForExit, oneShotRetainsDevices)
+{
+    Notifier notifier;
+
+    /* Returns without waiting for an exit signal */
+    notifier.setOneShot(true);
+    notifier.run();
+
+    EXPECT_EQ(0, notifier.getExitSignal());
+    EXPECT_EQ(Device::UNPLUG_RETAINS_DEVICES, unplugModeForExit(notifier));
+}
@@ -0,0 +1,162 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "platform.hpp"
+#include "polling.hpp"
+
+#include <poll.h>
+
+#include <chrono>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+using std::chrono::milliseconds;
+
+TEST(PollPolicies, defaults)
+{
+    PollPolicies policies;
+
+    EXPECT_EQ(milliseconds(1000), policies.get("default").interval);
+    EXPECT_EQ(milliseconds(1000), policies.get("default").latency);
+    EXPECT_EQ(milliseconds(8000), policies.get("backplane").latency);
+    /* Unknown classes use the default policy */
+    EXPECT_EQ(milliseconds(1000), policies.get("unknown").latency);
+}
+
+TEST(PollPolicies, load)
+{
+    PollPolicies policies;
+    std::istringstream config("# class interval-ms latency-ms\n"
+                              "drive 250 2000\n"
+                              "\n"
+                              "  custom\t100 100  # trailing comment\n");
+
+    EXPECT_TRUE(policies.load(config));
+    EXPECT_EQ(milliseconds(250), policies.get("drive").interval);
+    EXPECT_EQ(milliseconds(2000), policies.get("drive").latency);
+    EXPECT_EQ(milliseconds(100), policies.get("custom").latency);
+}
+
+TEST(PollPolicies, loadMalformed)
+{
+    PollPolicies policies;
+    std::istringstream config("drive 250\n"
+                              "backplane 0 100\n"
+                              "custom 500 100\n"
+                              "other 10 20 30\n");
+
+    EXPECT_FALSE(policies.load(config));
+    EXPECT_EQ(milliseconds(4000), policies.get("drive").latency);
+    EXPECT_EQ(milliseconds(8000), policies.get("backplane").latency);
+    EXPECT_EQ(milliseconds(1000), policies.get("custom").latency);
+    EXPECT_EQ(milliseconds(1000), policies.get("other").latency);
+}
+
+TEST(PollPolicies, loadBusBudget)
+{
+    PollPolicies policies;
+    std::istringstream config("bus-budget 8\n"
+                              "bus-budget many\n");
+
+    EXPECT_EQ(PollPolicies::defaultBusBudget, policies.getBusBudget());
+    EXPECT_FALSE(policies.load(config));
+    EXPECT_EQ(8U, policies.getBusBudget());
+}
+
+TEST(ProbeScheduler, phasesSpreadPerAdapter)
+{
+    PollPolicies policies;
+    ProbeScheduler scheduler(policies);
+
+    EXPECT_DOUBLE_EQ(0.5, scheduler.assignPhase(3));
+    EXPECT_DOUBLE_EQ(0.25, scheduler.assignPhase(3));
+    EXPECT_DOUBLE_EQ(0.75, scheduler.assignPhase(3));
+    EXPECT_DOUBLE_EQ(0.125, scheduler.assignPhase(3));
+    EXPECT_DOUBLE_EQ(0.5, scheduler.assignPhase(4));
+}
+
+TEST(ProbeScheduler, phasesReleased)
+{
+    PollPolicies policies;
+    ProbeScheduler scheduler(policies);
+
+    EXPECT_DOUBLE_EQ(0.5, scheduler.assignPhase(3));
+    EXPECT_DOUBLE_EQ(0.25, scheduler.assignPhase(3));
+
+    /* Hotplug churn reuses phases rather than refining them without bound */
+    for (int i = 0; i < 100; i++)
+    {
+        scheduler.releasePhase(3);
+        EXPECT_DOUBLE_EQ(0.25, scheduler.assignPhase(3));
+    }
+
+    scheduler.releasePhase(3);
+    scheduler.releasePhase(3);
+    scheduler.releasePhase(3);
+    EXPECT_DOUBLE_EQ(0.5, scheduler.assignPhase(3));
+}
+
+TEST(ProbeScheduler, budgetPerAdapterPerSecond)
+{
+    PollPolicies policies;
+    ProbeScheduler scheduler(policies);
+    auto now = std::chrono::steady_clock::now();
+
+    policies.setBusBudget(2);
+    EXPECT_TRUE(scheduler.tryAcquire(3, now));
+    EXPECT_TRUE(scheduler.tryAcquire(3, now));
+    EXPECT_FALSE(scheduler.tryAcquire(3, now + milliseconds(999)));
+    EXPECT_TRUE(scheduler.tryAcquire(4, now));
+    EXPECT_TRUE(scheduler.tryAcquire(ProbeScheduler::noAdapter, now));
+
+    /* The budget is renewed each second */
+    EXPECT_TRUE(scheduler.tryAcquire(3, now + milliseconds(1000)));
+
+    /* A zero budget is unlimited */
+    policies.setBusBudget(0);
+    EXPECT_TRUE(scheduler.tryAcquire(3, now + milliseconds(1000)));
+    EXPECT_TRUE(scheduler.tryAcquire(3, now + milliseconds(1000)));
+}
+
+TEST(PollTimer, backsOffWhileStable)
+{
+    PollPolicies::instance().set("test",
+                                 {milliseconds(100), milliseconds(350)});
+    PollTimer timer("test");
+
+    timer.arm();
+    EXPECT_EQ(milliseconds(100), timer.getInterval());
+
+    timer.schedule(false);
+    EXPECT_EQ(milliseconds(200), timer.getInterval());
+    timer.schedule(false);
+    EXPECT_EQ(milliseconds(350), timer.getInterval());
+    timer.schedule(false);
+    EXPECT_EQ(milliseconds(350), timer.getInterval());
+
+    timer.schedule(true);
+    EXPECT_EQ(milliseconds(100), timer.getInterval());
+
+    timer.disarm();
+}
+
+TEST(PollTimer, rescanExpiresImmediately)
+{
+    PollPolicies::instance().set("test",
+                                 {milliseconds(100), milliseconds(10000)});
+    PollTimer timer("test");
+
+    timer.arm();
+    timer.schedule(false);
+    timer.schedule(false);
+    ASSERT_EQ(milliseconds(400), timer.getInterval());
+
+    timer.rescan();
+    EXPECT_EQ(milliseconds(100), timer.getInterval());
+
+    struct pollfd pfd{timer.getFD(), POLLIN, 0};
+    EXPECT_EQ(1, ::poll(&pfd, 1, 50));
+    EXPECT_EQ(1, timer.drain());
+
+    timer.disarm();
+}
@@ -0,0 +1,526 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "notify.hpp"
+#include "platform.hpp"
+#include "presence.hpp"
+#include "temp-dir.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class NullDevice : public Device
+{
+  public:
+    void plug([[maybe_unused]] Notifier& notifier) override {}
+    void unplug([[maybe_unused]] Notifier& notifier,
+                [[maybe_unused]] int mode = UNPLUG_REMOVES_INVENTORY) override
+    {}
+};
+
+class PresenceTableTest : public ::testing::Test
+{
+  protected:
+    bool snapshot(presence::Snapshot& out)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        EXPECT_NE(-1, fd);
+        void* region = ::mmap(nullptr, sizeof(presence::Layout), PROT_READ,
+                              MAP_SHARED, fd, 0);
+        ::close(fd);
+        EXPECT_NE(MAP_FAILED, region);
+
+        bool valid = PresenceTable::read(
+            static_cast<const presence::Layout*>(region), out);
+
+        ::munmap(region, sizeof(presence::Layout));
+
+        return valid;
+    }
+
+    TemporaryDirectory dir{"presence"};
+    std::filesystem::path path = dir.getPath() / "presence";
+};
+
+TEST_F(PresenceTableTest, initiallyUnknown)
+{
+    PresenceTable table(path);
+    presence::Snapshot entries{};
+
+    ASSERT_TRUE(snapshot(entries));
+
+    for (const auto& entry : entries)
+    {
+        EXPECT_EQ(presence::STATE_UNKNOWN, entry.state);
+        EXPECT_EQ(0U, entry.transitions);
+        EXPECT_EQ(0U, entry.flaps);
+    }
+}
+
+TEST_F(PresenceTableTest, connectorTransitions)
+{
+    constexpr ConnectorID id = 5;
+    Notifier notifier;
+    PresenceTable table(path);
+    Connector<NullDevice> connector(0);
+    presence::Snapshot entries{};
+
+    notifier.addPresenceListener(&table);
+    connector.identify(id);
+
+    connector.populate(notifier);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(presence::STATE_PRESENT, entries.at(id).state);
+    EXPECT_EQ(1U, entries.at(id).transitions);
+
+    connector.depopulate(notifier);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(presence::STATE_ABSENT, entries.at(id).state);
+    EXPECT_EQ(2U, entries.at(id).transitions);
+
+    EXPECT_EQ(presence::STATE_UNKNOWN, entries.at(id + 1).state);
+
+    notifier.removePresenceListener(&table);
+}
+
+TEST_F(PresenceTableTest, connectorFlaps)
+{
+    constexpr ConnectorID id = 5;
+    Notifier notifier;
+    PresenceTable table(path);
+    Connector<NullDevice> connector(0);
+    presence::Snapshot entries{};
+
+    notifier.addPresenceListener(&table);
+    connector.identify(id);
+
+    connector.flapped(notifier, 1);
+    connector.flapped(notifier, 2);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(2U, entries.at(id).flaps);
+    EXPECT_EQ(0U, entries.at(id).transitions);
+    EXPECT_EQ(presence::STATE_UNKNOWN, entries.at(id).state);
+
+    notifier.removePresenceListener(&table);
+
+    /* Restored with the rest of the entry */
+    PresenceTable restarted(path);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(2U, entries.at(id).flaps);
+}
+
+TEST_F(PresenceTableTest, unidentifiedConnector)
+{
+    Notifier notifier;
+    PresenceTable table(path);
+    Connector<NullDevice> connector(0);
+    presence::Snapshot entries{};
+
+    notifier.addPresenceListener(&table);
+
+    connector.populate(notifier);
+    ASSERT_TRUE(snapshot(entries));
+
+    for (const auto& entry : entries)
+    {
+        EXPECT_EQ(presence::STATE_UNKNOWN, entry.state);
+    }
+
+    notifier.removePresenceListener(&table);
+}
+
+class UnplugCountingDevice : public Device
+{
+  public:
+    explicit UnplugCountingDevice(int* unplugged) : unplugged(unplugged) {}
+
+    void plug([[maybe_unused]] Notifier& notifier) override {}
+    void unplug([[maybe_unused]] Notifier& notifier,
+                [[maybe_unused]] int mode = UNPLUG_REMOVES_INVENTORY) override
+    {
+        (*unplugged)++;
+    }
+
+  private:
+    int* unplugged;
+};
+
+struct AdoptionCounts
+{
+    int plugged;
+    int adopted;
+    int verified;
+    uint32_t fingerprint;
+};
+
+class AdoptCountingDevice : public Device
+{
+  public:
+    explicit AdoptCountingDevice(AdoptionCounts* counts) : counts(counts) {}
+
+    void plug([[maybe_unused]] Notifier& notifier) override
+    {
+        counts->plugged++;
+    }
+
+    void unplug([[maybe_unused]] Notifier& notifier,
+                [[maybe_unused]] int mode = UNPLUG_REMOVES_INVENTORY) override
+    {}
+
+    uint32_t getFingerprint() const override
+    {
+        return counts->fingerprint;
+    }
+
+    void adopt([[maybe_unused]] Notifier& notifier,
+               uint32_t fingerprint) override
+    {
+        counts->adopted++;
+        counts->fingerprint = fingerprint;
+    }
+
+    void verify([[maybe_unused]] Notifier& notifier) override
+    {
+        counts->verified++;
+    }
+
+  private:
+    AdoptionCounts* counts;
+};
+
+static const presence::BootID thisBoot = {1, 2, 3, 4};
+static const presence::BootID nextBoot = {5, 6, 7, 8};
+
+TEST_F(PresenceTableTest, restoredWithinBoot)
+{
+    presence::Snapshot entries{};
+
+    {
+        PresenceTable table(path, thisBoot);
+        table.presenceChanged(3, false);
+        table.presenceChanged(4, true);
+        table.presenceIdentified(4, 0x1234);
+        EXPECT_FALSE(table.restoredAbsent().any());
+        EXPECT_FALSE(table.restoredPresent().any());
+    }
+
+    PresenceTable table(path, thisBoot);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(presence::STATE_ABSENT, entries.at(3).state);
+    EXPECT_EQ(presence::STATE_PRESENT, entries.at(4).state);
+    EXPECT_EQ(0x1234U, entries.at(4).fingerprint);
+
+    PresenceBitmap<presence::tableCapacity> absent;
+    absent.set(3);
+    EXPECT_EQ(absent, table.restoredAbsent());
+
+    PresenceBitmap<presence::tableCapacity> present;
+    present.set(4);
+    EXPECT_EQ(present, table.restoredPresent());
+    EXPECT_EQ(0x1234U, table.restoredFingerprints().at(4));
+}
+
+TEST_F(PresenceTableTest, republishedStateIsNotATransition)
+{
+    presence::Snapshot entries{};
+    PresenceTable table(path, thisBoot);
+
+    table.presenceChanged(4, true);
+    table.presenceIdentified(4, 0x1234);
+    table.presenceChanged(4, true);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(1U, entries.at(4).transitions);
+    EXPECT_EQ(0x1234U, entries.at(4).fingerprint);
+
+    /* The fingerprint only identifies a present FRU */
+    table.presenceChanged(4, false);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(2U, entries.at(4).transitions);
+    EXPECT_EQ(0U, entries.at(4).fingerprint);
+}
+
+TEST_F(PresenceTableTest, resetAcrossBoots)
+{
+    presence::Snapshot entries{};
+
+    {
+        PresenceTable table(path, thisBoot);
+        table.presenceChanged(3, false);
+    }
+
+    PresenceTable table(path, nextBoot);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(presence::STATE_UNKNOWN, entries.at(3).state);
+    EXPECT_FALSE(table.restoredAbsent().any());
+}
+
+TEST_F(PresenceTableTest, tornUpdateResetsTable)
+{
+    presence::Snapshot entries{};
+
+    {
+        PresenceTable table(path, thisBoot);
+        table.presenceChanged(3, false);
+    }
+
+    /* Simulate a writer that died between the two sequence updates */
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        int fd = ::open(path.c_str(), O_RDWR);
+        ASSERT_NE(-1, fd);
+        void* region = ::mmap(nullptr, sizeof(presence::Layout),
+                              PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        ASSERT_NE(MAP_FAILED, region);
+        static_cast<presence::Layout*>(region)->sequence.fetch_add(1);
+        ::munmap(region, sizeof(presence::Layout));
+    }
+
+    PresenceTable table(path, thisBoot);
+    EXPECT_FALSE(table.restoredAbsent().any());
+
+    /* Updates leave the sequence even so readers make progress */
+    table.presenceChanged(4, true);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(presence::STATE_UNKNOWN, entries.at(3).state);
+    EXPECT_EQ(presence::STATE_PRESENT, entries.at(4).state);
+}
+
+TEST_F(PresenceTableTest, retainedInventoryStaysPresent)
+{
+    constexpr ConnectorID id = 2;
+    Notifier notifier;
+    PresenceTable table(path, thisBoot);
+    Connector<NullDevice> connector(0);
+    presence::Snapshot entries{};
+
+    notifier.addPresenceListener(&table);
+    connector.identify(id);
+
+    connector.populate(notifier);
+    connector.depopulate(notifier, Device::UNPLUG_RETAINS_INVENTORY);
+    ASSERT_TRUE(snapshot(entries));
+    EXPECT_EQ(presence::STATE_PRESENT, entries.at(id).state);
+
+    notifier.removePresenceListener(&table);
+}
+
+TEST(RestoredPresence, skipsCleanupOfAbsentConnector)
+{
+    Notifier notifier;
+    PresenceBitmap<presence::tableCapacity> absent;
+    int unplugged = 0;
+    Connector<UnplugCountingDevice> restored(0, &unplugged);
+    Connector<UnplugCountingDevice> other(1, &unplugged);
+
+    absent.set(7);
+    notifier.restoreAbsent(absent);
+    restored.identify(7);
+    other.identify(8);
+
+    restored.depopulate(notifier);
+    EXPECT_EQ(0, unplugged);
+
+    other.depopulate(notifier);
+    EXPECT_EQ(1, unplugged);
+
+    /* The restored state is only used once */
+    EXPECT_FALSE(notifier.consumeRestoredAbsent(7));
+}
+
+TEST(RestoredPresence, adoptsPresentConnector)
+{
+    Notifier notifier;
+    PresenceBitmap<presence::tableCapacity> present;
+    presence::Fingerprints fingerprints{};
+    AdoptionCounts counts{};
+    Connector<AdoptCountingDevice> restored(0, &counts);
+
+    present.set(7);
+    fingerprints.at(7) = 0x1234;
+    notifier.restorePresent(present, fingerprints);
+    restored.identify(7);
+
+    restored.populate(notifier);
+    EXPECT_EQ(0, counts.plugged);
+    EXPECT_EQ(1, counts.adopted);
+    EXPECT_EQ(0x1234U, counts.fingerprint);
+    EXPECT_TRUE(restored.isAdopted());
+
+    /* Verified once, by the first poll after adoption */
+    restored.verify(notifier);
+    restored.verify(notifier);
+    EXPECT_EQ(1, counts.verified);
+    EXPECT_FALSE(restored.isAdopted());
+
+    /* The restored state is only used once */
+    EXPECT_FALSE(notifier.consumeRestoredPresent(7));
+
+    restored.depopulate(notifier);
+    restored.populate(notifier);
+    EXPECT_EQ(1, counts.plugged);
+    EXPECT_EQ(1, counts.adopted);
+}
+
+TEST(RestoredPresence, plugsUnrestoredConnector)
+{
+    Notifier notifier;
+    AdoptionCounts counts{};
+    Connector<AdoptCountingDevice> connector(0, &counts);
+
+    connector.identify(7);
+    connector.populate(notifier);
+    EXPECT_EQ(1, counts.plugged);
+    EXPECT_EQ(0, counts.adopted);
+    EXPECT_FALSE(connector.isAdopted());
+
+    connector.verify(notifier);
+    EXPECT_EQ(0, counts.verified);
+}
+
+TEST(PresenceBitmap, setAndTest)
+{
+    PresenceBitmap<70> bitmap;
+
+    EXPECT_FALSE(bitmap.any());
+
+    bitmap.set(3);
+    bitmap.set(69);
+    EXPECT_TRUE(bitmap.test(3));
+    EXPECT_TRUE(bitmap.test(69));
+    EXPECT_FALSE(bitmap.test(4));
+    EXPECT_EQ(2U, bitmap.count());
+
+    bitmap.reset(3);
+    EXPECT_FALSE(bitmap.test(3));
+    EXPECT_EQ(1U, bitmap.count());
+
+    bitmap.clear();
+    EXPECT_FALSE(bitmap.any());
+}
+
+TEST(PresenceBitmap, walkChanges)
+{
+    PresenceBitmap<130> before;
+    PresenceBitmap<130> after;
+    std::vector<std::size_t> changed;
+
+    before.set(1);
+    before.set(64);
+    after.set(1);
+    after.set(65);
+    after.set(129);
+
+    (before ^ after).forEach(
+        [&changed](std::size_t index) { changed.push_back(index); });
+
+    EXPECT_EQ(std::vector<std::size_t>({64, 65, 129}), changed);
+}
+
+TEST(PresenceModel, pending)
+{
+    PresenceModel<8> model;
+
+    EXPECT_FALSE(model.pending().any());
+
+    model.debounced.set(2);
+    model.unsettled.set(5);
+    model.published.set(6);
+
+    PresenceBitmap<8> expected;
+    expected.set(2);
+    expected.set(5);
+    expected.set(6);
+    EXPECT_EQ(expected, model.pending());
+}
+
+TEST(PresenceTally, countsPresentConnectors)
+{
+    PresenceTally tally;
+
+    tally.presenceChanged(0, true);
+    tally.presenceChanged(5, true);
+    tally.presenceChanged(5, false);
+    tally.presenceChanged(7, true);
+    tally.presenceChanged(presence::unassigned, true);
+
+    EXPECT_EQ(2U, tally.count());
+}
+
+class RecordingSubscriber : public PresenceSubscriber
+{
+  public:
+    void presenceEvents(std::span<const PresenceEvent> events) override
+    {
+        batches++;
+        received.insert(received.end(), events.begin(), events.end());
+    }
+
+    int batches = 0;
+    std::vector<PresenceEvent> received;
+};
+
+TEST(PresenceEventBus, batchedTransitions)
+{
+    Notifier notifier;
+    RecordingSubscriber subscriber;
+
+    notifier.addPresenceSubscriber(&subscriber);
+
+    notifier.presenceChanged(3, true);
+    notifier.presenceChanged(4, false);
+    /* Re-publishing the current state isn't a transition */
+    notifier.presenceChanged(3, true);
+    notifier.presenceChanged(3, false);
+    notifier.presenceChanged(presence::unassigned, true);
+    EXPECT_EQ(0, subscriber.batches);
+
+    notifier.flushPresenceEvents();
+    ASSERT_EQ(1, subscriber.batches);
+    ASSERT_EQ(2U, subscriber.received.size());
+
+    /* Publishing an empty slot for the first time isn't a transition */
+    EXPECT_EQ(3, subscriber.received.at(0).id);
+    EXPECT_FALSE(subscriber.received.at(0).previous);
+    EXPECT_TRUE(subscriber.received.at(0).present);
+
+    EXPECT_EQ(3, subscriber.received.at(1).id);
+    EXPECT_TRUE(subscriber.received.at(1).previous);
+    EXPECT_FALSE(subscriber.received.at(1).present);
+    EXPECT_LE(subscriber.received.at(0).timestamp,
+              subscriber.received.at(1).timestamp);
+
+    /* Empty batches aren't delivered */
+    notifier.flushPresenceEvents();
+    EXPECT_EQ(1, subscriber.batches);
+
+    notifier.removePresenceSubscriber(&subscriber);
+}
+
+TEST(PresenceEventBus, fullBatchDelivered)
+{
+    Notifier notifier;
+    RecordingSubscriber subscriber;
+    constexpr int transitions = 200;
+
+    notifier.addPresenceSubscriber(&subscriber);
+
+    for (int i = 0; i < transitions; i++)
+    {
+        notifier.presenceChanged(0, (i % 2) == 0);
+    }
+    EXPECT_EQ(1, subscriber.batches);
+
+    notifier.flushPresenceEvents();
+    EXPECT_EQ(2, subscriber.batches);
+    EXPECT_EQ(static_cast<std::size_t>(transitions),
+              subscriber.received.size());
+
+    notifier.removePresenceSubscriber(&subscriber);
+}
@@ -0,0 +1,140 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "notify.hpp"
+#include "startup.hpp"
+#include "temp-dir.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "gtest/gtest.h"
+
+class StartupReportTest : public ::testing::Test
+{
+  protected:
+    void TearDown() override
+    {
+        ::unsetenv("NOTIFY_SOCKET");
+    }
+
+    TemporaryDirectory tmp{"startup"};
+    const std::filesystem::path& dir = tmp.getPath();
+    std::filesystem::path marker = dir / "run" / "startup-reported";
+};
+
+TEST_F(StartupReportTest, phasesRecordedUntilReady)
+{
+    StartupReport report(marker);
+
+    {
+        StartupReport::Phase first = report.phase("first");
+        StartupReport::Phase second = report.phase("second");
+        second.end();
+    }
+
+    report.ready();
+
+    {
+        StartupReport::Phase late = report.phase("late");
+    }
+
+    auto phases = report.getPhases();
+    ASSERT_EQ(2U, phases.size());
+    EXPECT_EQ("second", phases.at(0).first);
+    EXPECT_EQ("first", phases.at(1).first);
+    EXPECT_TRUE(report.isReady());
+}
+
+TEST_F(StartupReportTest, reportedOncePerBoot)
+{
+    {
+        StartupReport report(marker);
+        report.ready();
+    }
+    EXPECT_TRUE(std::filesystem::exists(marker));
+
+    /* A restart finds the marker and doesn't fail on it */
+    StartupReport restarted(marker);
+    restarted.ready();
+    EXPECT_TRUE(restarted.isReady());
+}
+
+TEST_F(StartupReportTest, notifierReportsReadiness)
+{
+    std::filesystem::path socketPath = dir / "notify";
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    ASSERT_NE(-1, fd);
+
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    ::strncpy(&addr.sun_path[0], socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(0, ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                        sizeof(addr)));
+    ::setenv("NOTIFY_SOCKET", socketPath.c_str(), 1);
+
+    StartupReport report(marker);
+    Notifier notifier;
+    notifier.setStartupReport(&report);
+
+    {
+        StartupReport::Phase phase = notifier.startupPhase("Plugging");
+    }
+
+    std::array<char, 128> buf{};
+    ssize_t len = ::recv(fd, buf.data(), buf.size(), MSG_DONTWAIT);
+    EXPECT_EQ("STATUS=Plugging", std::string(buf.data(), len));
+
+    /* Stand in for run(), which reports readiness before waiting on events */
+    report.ready();
+
+    len = ::recv(fd, buf.data(), buf.size(), MSG_DONTWAIT);
+    ASSERT_GT(len, 0);
+    EXPECT_EQ(0, std::string(buf.data(), len).rfind("READY=1\n", 0));
+
+    ::close(fd);
+}
+
+TEST_F(StartupReportTest, finishReportsReadinessOnExit)
+{
+    std::filesystem::path socketPath = dir / "notify";
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    ASSERT_NE(-1, fd);
+
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    ::strncpy(&addr.sun_path[0], socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(0, ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                        sizeof(addr)));
+    ::setenv("NOTIFY_SOCKET", socketPath.c_str(), 1);
+
+    StartupReport report(marker);
+    report.finish("Unsupported platform");
+
+    std::array<char, 128> buf{};
+    ssize_t len = ::recv(fd, buf.data(), buf.size(), MSG_DONTWAIT);
+    EXPECT_EQ("READY=1\nSTATUS=Unsupported platform",
+              std::string(buf.data(), len));
+
+    /* Readiness is only sent once, and an early exit claims no report */
+    report.ready();
+    EXPECT_EQ(-1, ::recv(fd, buf.data(), buf.size(), MSG_DONTWAIT));
+    EXPECT_FALSE(std::filesystem::exists(marker));
+
+    ::close(fd);
+}
+
+TEST(StartupReport, phaseWithoutReport)
+{
+    Notifier notifier;
+
+    /* Without a report the phases are inert */
+    StartupReport::Phase phase = notifier.startupPhase("Plugging");
+    phase.end();
+}
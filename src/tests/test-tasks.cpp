@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "tasks.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(TaskGroup, inlineWithoutPool)
+{
+    std::thread::id self = std::this_thread::get_id();
+    std::thread::id executor;
+    TaskGroup group;
+
+    group.spawn([&executor]() { executor = std::this_thread::get_id(); });
+    group.wait();
+
+    EXPECT_EQ(self, executor);
+}
+
+TEST(TaskGroup, completesAllWork)
+{
+    std::atomic<int> completed = 0;
+    WorkPool pool;
+    TaskGroup group;
+
+    for (int i = 0; i < 64; i++)
+    {
+        group.spawn([&completed]() { completed++; });
+    }
+    group.wait();
+
+    EXPECT_EQ(64, completed);
+}
+
+TEST(TaskGroup, nestedGroups)
+{
+    std::atomic<int> completed = 0;
+    WorkPool pool(1);
+    TaskGroup outer;
+
+    for (int i = 0; i < 4; i++)
+    {
+        outer.spawn([&completed]() {
+            TaskGroup inner;
+            for (int j = 0; j < 4; j++)
+            {
+                inner.spawn([&completed]() { completed++; });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+
+    EXPECT_EQ(16, completed);
+}
+
+TEST(TaskGroup, concurrentWork)
+{
+    std::atomic<int> arrived = 0;
+    WorkPool pool(2);
+    TaskGroup group;
+
+    /* Deadlocks unless the work executes concurrently */
+    for (int i = 0; i < 2; i++)
+    {
+        group.spawn([&arrived]() {
+            arrived++;
+            while (arrived < 2)
+            {
+                std::this_thread::yield();
+            }
+        });
+    }
+    group.wait();
+
+    EXPECT_EQ(2, arrived);
+}
+
+TEST(TaskGroup, propagatesException)
+{
+    std::atomic<int> completed = 0;
+    WorkPool pool;
+    TaskGroup group;
+
+    group.spawn([]() { throw std::runtime_error("failed"); });
+    group.spawn([&completed]() { completed++; });
+
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(1, completed);
+}
+
+TEST(TaskGroup, destructorWaitsForWork)
+{
+    std::atomic<int> completed = 0;
+    WorkPool pool(1);
+
+    try
+    {
+        TaskGroup group;
+
+        for (int i = 0; i < 4; i++)
+        {
+            group.spawn([&completed]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                completed++;
+            });
+        }
+
+        throw std::runtime_error("unwound before wait");
+    }
+    catch (const std::runtime_error&)
+    {
+        EXPECT_EQ(4, completed);
+    }
+}
+
+TEST(TaskGroup, propagatesInlineException)
+{
+    TaskGroup group;
+
+    group.spawn([]() { throw std::runtime_error("failed"); });
+
+    EXPECT_THROW(group.wait(), std::runtime_error);
+}
@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "sysfs/i2c.hpp"
+#include "temp-dir.hpp"
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+/*
+ * Model the layout of /sys/bus/i2c/devices: a root adapter i2c-3 hosting a
+ * pca9546 at 0x70 that provides i2c-10 and i2c-11, and a pca9552 at 0x60
+ * that provides a gpiochip.
+ */
+class SysfsI2CTopologyTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        fs::create_directory(root / "i2c-3");
+        fs::create_directory(root / "i2c-10");
+        fs::create_directory(root / "i2c-11");
+        fs::create_directory(root / "3-0070");
+        fs::create_directory_symlink("../i2c-10", root / "3-0070/channel-0");
+        fs::create_directory_symlink("../i2c-11", root / "3-0070/channel-1");
+        fs::create_directory(root / "3-0060");
+        fs::create_directory(root / "3-0060/gpiochip7");
+    }
+
+    TemporaryDirectory dir{"topology"};
+    const fs::path& root = dir.getPath();
+};
+
+TEST(SysfsI2CBus, busNumberFromPath)
+{
+    SysfsI2CBus bus("/sys/bus/i2c/devices/i2c-13", false);
+
+    EXPECT_EQ(13, bus.getAddress());
+    EXPECT_EQ("i2c-13", bus.getID());
+    EXPECT_EQ(fs::path("/dev/i2c-13"), bus.getBusDevice());
+    EXPECT_EQ(-1, SysfsI2CBus::extractBusNumber("/sys/bus/i2c/devices/i2c-"));
+    EXPECT_EQ(-1, SysfsI2CBus::extractBusNumber("/sys/devices/channel-1"));
+}
+
+TEST_F(SysfsI2CTopologyTest, rooted)
+{
+    sysfs::setRoot(root / "");
+
+    SysfsI2CBus bus("/i2c-3");
+    EXPECT_EQ(root / "i2c-3", bus.getPath());
+    EXPECT_EQ(root / "dev/i2c-3", bus.getBusDevice());
+
+    /* Paths derived from rooted entries aren't rooted again */
+    SysfsI2CDevice device(bus.getPath().parent_path() / "3-0060");
+    EXPECT_EQ(root / "3-0060", device.getPath());
+    EXPECT_EQ(fs::path("relative"), sysfs::rooted("relative"));
+
+    sysfs::setRoot("/");
+    EXPECT_TRUE(sysfs::getRoot().empty());
+    EXPECT_EQ(fs::path("/dev/i2c-3"), sysfs::rooted("/dev/i2c-3"));
+}
+
+TEST_F(SysfsI2CTopologyTest, deviceTypeFitsI2CName)
+{
+    SysfsI2CBus bus(root / "i2c-3", false);
+
+    /* I2C_NAME_SIZE counts the terminator */
+    EXPECT_THROW(bus.newDevice(std::string(20, 'x'), 0x50),
+                 std::error_condition);
+    EXPECT_FALSE(fs::exists(root / "i2c-3" / "new_device"));
+}
+
+TEST_F(SysfsI2CTopologyTest, unindexed)
+{
+    SysfsI2CTopology topology(root);
+
+    EXPECT_FALSE(topology.isIndexed());
+    EXPECT_FALSE(topology.findBus(3));
+    EXPECT_FALSE(topology.hasDevice(3, 0x70));
+}
+
+TEST_F(SysfsI2CTopologyTest, scan)
+{
+    SysfsI2CTopology topology(root);
+
+    ASSERT_TRUE(topology.scan());
+    EXPECT_TRUE(topology.isIndexed());
+
+    ASSERT_TRUE(topology.findBus(3));
+    EXPECT_EQ(root / "i2c-3", topology.findBus(3)->getPath());
+    EXPECT_FALSE(topology.findBus(4));
+
+    auto channel = topology.findMuxChannel(3, 0x70, 1);
+    ASSERT_TRUE(channel);
+    EXPECT_EQ(11, channel->getAddress());
+    EXPECT_FALSE(topology.findMuxChannel(3, 0x70, 2));
+    EXPECT_EQ(3, topology.findMuxParent(11));
+    EXPECT_FALSE(topology.findMuxParent(3));
+    EXPECT_EQ(3, topology.findRootAdapter(11));
+    EXPECT_EQ(3, topology.findRootAdapter(3));
+
+    EXPECT_TRUE(topology.hasDevice(3, 0x60));
+    EXPECT_EQ(root / "3-0060" / "gpiochip7", topology.findGPIOChip(3, 0x60));
+    EXPECT_EQ(root / "3-0060" / "gpiochip7",
+              topology.findGPIOChip(root / "3-0060"));
+    EXPECT_FALSE(topology.findGPIOChip(3, 0x70));
+}
+
+TEST_F(SysfsI2CTopologyTest, incrementalUpdates)
+{
+    SysfsI2CTopology topology(root);
+
+    ASSERT_TRUE(topology.scan());
+
+    /* A new mux is bound behind a channel of the first */
+    fs::create_directory(root / "i2c-12");
+    fs::create_directory(root / "10-0071");
+    fs::create_directory_symlink("../i2c-12", root / "10-0071/channel-3");
+    EXPECT_FALSE(topology.findMuxChannel(10, 0x71, 3));
+
+    topology.update(10, 0x71);
+    ASSERT_TRUE(topology.findMuxChannel(10, 0x71, 3));
+    EXPECT_EQ(12, topology.findMuxChannel(10, 0x71, 3)->getAddress());
+
+    topology.remove(3, 0x70);
+    EXPECT_FALSE(topology.hasDevice(3, 0x70));
+    EXPECT_FALSE(topology.findMuxChannel(3, 0x70, 0));
+    EXPECT_FALSE(topology.findBus(10));
+    EXPECT_TRUE(topology.hasDevice(10, 0x71));
+}
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "uevent.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <span>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+
+static std::string makeUevent(const std::string& action,
+                              const std::string& devpath,
+                              const std::string& subsystem)
+{
+    std::string message = action + "@" + devpath;
+    message.push_back('\0');
+    for (const auto& field :
+         {"ACTION=" + action, "DEVPATH=" + devpath, "SUBSYSTEM=" + subsystem,
+          std::string("SEQNUM=1")})
+    {
+        message.append(field);
+        message.push_back('\0');
+    }
+
+    return message;
+}
+
+static constexpr auto clientPath =
+    "/devices/platform/ahb/ahb:apb/1e78a400.i2c-bus/i2c-3/3-0070";
+
+TEST(UeventMonitor, parseClientBind)
+{
+    std::string message = makeUevent("bind", clientPath, "i2c");
+    auto event =
+        UeventMonitor::parse(std::span(message.data(), message.size()));
+
+    ASSERT_TRUE(event);
+    EXPECT_EQ(UeventMonitor::Action::BIND, event->action);
+    EXPECT_EQ(3, event->bus);
+    EXPECT_EQ(0x70, event->address);
+}
+
+TEST(UeventMonitor, parseIgnoresOthers)
+{
+    std::string adapter = makeUevent("add", "/devices/platform/i2c-3", "i2c");
+    EXPECT_FALSE(
+        UeventMonitor::parse(std::span(adapter.data(), adapter.size())));
+
+    std::string gpio = makeUevent("add", clientPath, "gpio");
+    EXPECT_FALSE(UeventMonitor::parse(std::span(gpio.data(), gpio.size())));
+
+    std::string change = makeUevent("change", clientPath, "i2c");
+    EXPECT_FALSE(UeventMonitor::parse(std::span(change.data(), change.size())));
+
+    /* Events forwarded by udev aren't from the kernel */
+    std::string udev("libudev\0ACTION=bind\0SUBSYSTEM=i2c", 32);
+    EXPECT_FALSE(UeventMonitor::parse(std::span(udev.data(), udev.size())));
+}
+
+TEST(UeventMonitor, waitForDriver)
+{
+    std::array<int, 2> fds{};
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0,
+                              fds.data()));
+    UeventMonitor monitor(fds[0]);
+
+    /* No bind arrives before the deadline */
+    EXPECT_FALSE(monitor.waitForDriver(3, 0x70, 10ms));
+
+    std::thread kernel([&fds]() {
+        std::this_thread::sleep_for(20ms);
+        std::string bind = makeUevent("bind", clientPath, "i2c");
+        ::send(fds[1], bind.data(), bind.size(), 0);
+    });
+
+    EXPECT_TRUE(monitor.waitForDriver(3, 0x70, 2000ms));
+    kernel.join();
+
+    /* An unbind queued ahead of the wait is applied before it checks */
+    std::string unbind = makeUevent("unbind", clientPath, "i2c");
+    ASSERT_GT(::send(fds[1], unbind.data(), unbind.size(), 0), 0);
+    EXPECT_FALSE(monitor.waitForDriver(3, 0x70, 10ms));
+
+    ::close(fds[1]);
+}
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#include "devices/vpd.hpp"
+#include "sysfs/eeprom.hpp"
+#include "temp-dir.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+/* A large resource holding the named record and its keywords */
+static std::string record(const std::string& name, const std::string& keywords)
+{
+    std::string body = "RT" + std::string(1, static_cast<char>(name.size())) +
+                       name + keywords + "PF" + std::string(1, '\x01') + '\0';
+    std::string resource(1, '\x84');
+
+    resource += static_cast<char>(body.size() & 0xff);
+    resource += static_cast<char>(body.size() >> 8);
+
+    return resource + body + '\x78';
+}
+
+static std::string image()
+{
+    return std::string(11, '\0') + record("VHDR", "VD\x02" "01") +
+           record("VINI", "DR\x10" "PCIE4 NVME CARD " "CC\x04" "6B87");
+}
+
+TEST(VPD, findKeyword)
+{
+    std::string vpd = image();
+
+    EXPECT_EQ("6B87", vpd::findKeyword(vpd, "VINI", "CC"));
+    EXPECT_EQ("01", vpd::findKeyword(vpd, "VHDR", "VD"));
+    EXPECT_FALSE(vpd::findKeyword(vpd, "VINI", "SN"));
+    EXPECT_FALSE(vpd::findKeyword(vpd, "VSYS", "CC"));
+}
+
+TEST(VPD, truncated)
+{
+    std::string vpd = image();
+
+    EXPECT_FALSE(vpd::findKeyword({vpd.data(), vpd.size() - 6}, "VINI", "CC"));
+    EXPECT_FALSE(vpd::findKeyword({}, "VINI", "CC"));
+}
+
+TEST(VPD, readCCIN)
+{
+    TemporaryDirectory dir("vpd");
+    const fs::path& root = dir.getPath();
+
+    std::ofstream(root / "eeprom", std::ios::binary) << image();
+    SysfsEEPROM eeprom(root / "eeprom");
+
+    EXPECT_EQ("6B87", vpd::readCCIN(eeprom));
+
+    std::string erased(256, '\xff');
+    std::ofstream(root / "eeprom", std::ios::binary) << erased;
+    EXPECT_FALSE(vpd::readCCIN(eeprom));
+}
@@ -0,0 +1,279 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+
+#include "uevent.hpp"
+
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+PHOSPHOR_LOG2_USING;
+
+using namespace std::chrono;
+
+/* The kernel's uevent multicast group, as opposed to udev's */
+static constexpr uint32_t kernelUeventGroup = 1;
+
+std::optional<UeventMonitor::Event>
+    UeventMonitor::parse(std::span<const char> message)
+{
+    std::string_view data(message.data(), message.size());
+
+    /* Kernel events lead with 'action@devpath', udev's with 'libudev' */
+    std::string_view::size_type end = data.find('\0');
+    if (end == std::string_view::npos ||
+        data.substr(0, end).find('@') == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+
+    std::string_view action;
+    std::string_view devpath;
+    std::string_view subsystem;
+
+    while (end < data.size())
+    {
+        std::string_view::size_type begin = end + 1;
+        end = data.find('\0', begin);
+        if (end == std::string_view::npos)
+        {
+            end = data.size();
+        }
+
+        std::string_view field = data.substr(begin, end - begin);
+        if (field.starts_with("ACTION="))
+        {
+            action = field.substr(7);
+        }
+        else if (field.starts_with("DEVPATH="))
+        {
+            devpath = field.substr(8);
+        }
+        else if (field.starts_with("SUBSYSTEM="))
+        {
+            subsystem = field.substr(10);
+        }
+    }
+
+    if (subsystem != "i2c")
+    {
+        return std::nullopt;
+    }
+
+    Event event{};
+    if (action == "add")
+    {
+        event.action = Action::ADD;
+    }
+    else if (action == "remove")
+    {
+        event.action = Action::REMOVE;
+    }
+    else if (action == "bind")
+    {
+        event.action = Action::BIND;
+    }
+    else if (action == "unbind")
+    {
+        event.action = Action::UNBIND;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    /* Adapters are named i2c-N, clients are named like 11-0075 */
+    std::string id(devpath.substr(devpath.rfind('/') + 1));
+    if (!SysfsI2CDevice::extractBusAddress(id, event.bus, event.address))
+    {
+        return std::nullopt;
+    }
+
+    return event;
+}
+
+UeventMonitor::UeventMonitor() :
+    fd(::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+                NETLINK_KOBJECT_UEVENT))
+{
+    if (fd == -1)
+    {
+        error("Failed to create uevent socket: {ERRNO_DESCRIPTION}",
+              "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO", errno);
+        throw std::system_category().default_error_condition(errno);
+    }
+
+    struct sockaddr_nl addr{};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = kernelUeventGroup;
+
+    int rc = ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                    sizeof(addr));
+    if (rc == -1)
+    {
+        int err = errno;
+        ::close(fd);
+        error("Failed to bind uevent socket: {ERRNO_DESCRIPTION}",
+              "ERRNO_DESCRIPTION", ::strerror(err), "ERRNO", err);
+        throw std::system_category().default_error_condition(err);
+    }
+}
+
+UeventMonitor::UeventMonitor(int fd) : fd(fd) {}
+
+UeventMonitor::~UeventMonitor()
+{
+    ::close(fd);
+}
+
+int UeventMonitor::getFD()
+{
+    return fd;
+}
+
+void UeventMonitor::notify([[maybe_unused]] Notifier& notifier)
+{
+    std::lock_guard reader(readLock);
+    drain();
+}
+
+void UeventMonitor::drain()
+{
+    for (;;)
+    {
+        ssize_t len = ::recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (len == -1)
+        {
+            if (errno == ENOBUFS)
+            {
+                /* Events were dropped, refresh what we can */
+                warning("Overran uevent socket, re-indexing I2C topology");
+                SysfsI2CTopology::instance().scan();
+                continue;
+            }
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                warning("Failed to read uevent: {ERRNO_DESCRIPTION}",
+                        "ERRNO_DESCRIPTION", ::strerror(errno), "ERRNO",
+                        errno);
+            }
+
+            return;
+        }
+
+        std::optional<Event> event =
+            parse(std::span<const char>(buffer.data(), len));
+        if (event)
+        {
+            apply(*event);
+        }
+    }
+}
+
+void UeventMonitor::apply(const Event& event)
+{
+    SysfsI2CTopology& topology = SysfsI2CTopology::instance();
+
+    switch (event.action)
+    {
+        case Action::ADD:
+        case Action::BIND:
+        case Action::UNBIND:
+            topology.update(event.bus, event.address);
+            break;
+        case Action::REMOVE:
+            topology.remove(event.bus, event.address);
+            break;
+    }
+
+    {
+        std::lock_guard guard(lock);
+        uint32_t key = deviceKey(event.bus, event.address);
+        if (event.action == Action::BIND)
+        {
+            drivers.insert_or_assign(key, true);
+        }
+        else if (event.action == Action::REMOVE)
+        {
+            drivers.erase(key);
+        }
+        else
+        {
+            drivers.insert_or_assign(key, false);
+        }
+    }
+
+    changed.notify_all();
+
+    debug("Applied uevent for I2C device {I2C_BUS}-{I2C_ADDRESS}", "I2C_BUS",
+          event.bus, "I2C_ADDRESS", lg2::hex, event.address);
+}
+
+bool UeventMonitor::isBound(uint32_t key)
+{
+    std::lock_guard guard(lock);
+    auto found = drivers.find(key);
+
+    return found != drivers.end() && found->second;
+}
+
+bool UeventMonitor::waitForDriver(int bus, int address, milliseconds timeout)
+{
+    steady_clock::time_point deadline = steady_clock::now() + timeout;
+    uint32_t key = deviceKey(bus, address);
+
+    for (;;)
+    {
+        std::unique_lock reader(readLock, std::try_to_lock);
+        if (reader.owns_lock())
+        {
+            /* Apply what's queued so earlier unbinds aren't missed */
+            drain();
+            if (isBound(key))
+            {
+                return true;
+            }
+
+            auto remaining =
+                duration_cast<milliseconds>(deadline - steady_clock::now());
+            if (remaining.count() <= 0)
+            {
+                return false;
+            }
+
+            struct pollfd pfd{fd, POLLIN, 0};
+            ::poll(&pfd, 1,
+                   static_cast<int>(std::min(remaining, pollSlice).count()));
+            continue;
+        }
+
+        /* Another probe is reading the socket, wait for it to apply events */
+        std::unique_lock guard(lock);
+        auto slice = std::min(deadline, steady_clock::now() + pollSlice);
+        changed.wait_until(guard, slice, [this, key]() {
+            auto found = drivers.find(key);
+            return found != drivers.end() && found->second;
+        });
+
+        auto found = drivers.find(key);
+        if (found != drivers.end() && found->second)
+        {
+            return true;
+        }
+
+        if (steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright IBM Corp. 2022 */
+#pragma once
+
+#include "notify.hpp"
+#include "sysfs/i2c.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+
+/*
+ * Monitors kernel uevents for I2C client devices.
+ *
+ * Driver bind and unbind events are tracked so probes can wait for a bind to
+ * complete, and device add and remove events keep the SysfsI2CTopology index
+ * current. The socket is drained by the notifier once it runs, and by waiting
+ * probes during cold-plug.
+ */
+class UeventMonitor : public NotifySink, public SysfsI2CDriverBindWaiter
+{
+  public:
+    enum class Action
+    {
+        ADD,
+        REMOVE,
+        BIND,
+        UNBIND,
+    };
+
+    struct Event
+    {
+        Action action;
+        int bus;
+        int address;
+    };
+
+    /* Parse a kernel uevent, ignoring anything but I2C client devices */
+    static std::optional<Event> parse(std::span<const char> message);
+
+    UeventMonitor();
+    /* Takes ownership of fd, which must deliver uevent datagrams */
+    explicit UeventMonitor(int fd);
+    UeventMonitor(const UeventMonitor& other) = delete;
+    UeventMonitor(UeventMonitor&& other) = delete;
+    virtual ~UeventMonitor();
+
+    UeventMonitor& operator=(const UeventMonitor& other) = delete;
+    UeventMonitor& operator=(UeventMonitor&& other) = delete;
+
+    /* NotifySink */
+    int getFD() override;
+    void notify(Notifier& notifier) override;
+
+    /* SysfsI2CDriverBindWaiter */
+    bool waitForDriver(int bus, int address,
+                       std::chrono::milliseconds timeout) override;
+
+  private:
+    static constexpr std::chrono::milliseconds pollSlice{50};
+
+    static constexpr uint32_t deviceKey(int bus, int address)
+    {
+        return (static_cast<uint32_t>(bus) << 16) |
+               static_cast<uint32_t>(address);
+    }
+
+    void drain();
+    void apply(const Event& event);
+    bool isBound(uint32_t key);
+
+    int fd;
+    /* Held by whichever thread is reading the socket */
+    std::mutex readLock;
+    std::array<char, 8192> buffer{};
+    /* Protects drivers */
+    std::mutex lock;
+    std::condition_variable changed;
+    std::map<uint32_t, bool> drivers;
+};